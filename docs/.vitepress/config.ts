@@ -153,6 +153,7 @@ function makeSidebarHooks(): DefaultTheme.SidebarItem[] {
                 { text: 'Address Fetching', link: 'address-fetching' },
                 { text: 'Hook Handles', link: 'hook-handles' },
                 { text: 'Trampoline', link: 'trampoline' },
+                { text: 'Platform', link: 'platform' },
             ]
         },
         {
@@ -160,6 +161,8 @@ function makeSidebarHooks(): DefaultTheme.SidebarItem[] {
             collapsed: false,
             items: [
                 { text: 'Relocation', link: 'relocation' },
+                { text: 'Hook Chain', link: 'hook-chain' },
+                { text: 'Hook Stats', link: 'hook-stats' },
                 { text: 'ASM Patch', link: 'asm-patch' },
                 { text: 'Cave Hook', link: 'cave-hook' },
                 { text: 'VTable Swap', link: 'vtable-swap' },
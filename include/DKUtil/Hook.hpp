@@ -1,6 +1,123 @@
 #pragma once
 
 /** 
+ * 2.6.44
+ * profiled relocation hooks are named by destination in HookStats;
+ * 
+ * 2.6.43
+ * relocated loop and jecxz keep their address size prefix;
+ * 
+ * 2.6.42
+ * cave hook blocks are kept on destruction, HookHandle::Release returns them;
+ * 
+ * 2.6.41
+ * InstallBatch skips threads blocking the quiesce signal;
+ * 
+ * 2.6.40
+ * ModuleRegistry rebuilds once per change, misses without loader notification ask the loader first;
+ * 
+ * 2.6.39
+ * PatchTransaction asserts LIFO close, commit may throw;
+ * 
+ * 2.6.38
+ * SignatureCache save never throws, entries compiled once;
+ * 
+ * 2.6.37
+ * export ordinals take ExportOrdinal;
+ * 
+ * 2.6.36
+ * cache the parsed linux memory map in Platform::query, standalone DKUtilTest target;
+ * 
+ * 2.6.35
+ * CallerProfiler countdown samples on jle, racing decrements below zero no longer stall sampling;
+ * 
+ * 2.6.34
+ * AVX::K uses kmovw without AVX512BW, AVX::YMM and AVX::ZMM assert without SIMD registers;
+ * 
+ * 2.6.33
+ * InstallBatch parks linux threads in a quiesce signal handler, relists threads until stable and uses cmpxchg16b outside msvc;
+ * 
+ * 2.6.32
+ * HookChain dispatches through one thunk per chain reading a swapped table, GetNext is lock free on detour_t, rel and cave hooks assert on chain owned sites;
+ * 
+ * 2.6.31
+ * CallerProfiler samples return addresses of vmt or cave hooked functions into per thread rings, top callers by GetRawAddress;
+ * 
+ * 2.6.30
+ * HookFlag::kProfile counts calls and cycles of rel, cave and vmt hooks in cache line padded HookStats;
+ * 
+ * 2.6.29
+ * write_call_ex preserves ymm/zmm width and opmasks, or full state by xsavec/xrstor sized from cpuid;
+ * 
+ * 2.6.28
+ * Non volatile patches are generated at compile time for write_call_ex<N, Flags...>, runtime cache is locked;
+ * 
+ * 2.6.27
+ * HookChain dispatches one call site to prioritized handlers and detours, regenerated thunk is swapped atomically;
+ * 
+ * 2.6.26
+ * AddVMTShadowHook swaps vptr of a single object to a shared, rtti preserving vtable clone;
+ * 
+ * 2.6.25
+ * FunctionAt binary searches .pdata/.eh_frame_hdr, GetFuncPrologAddr falls back to padding walk without unwind data;
+ * 
+ * 2.6.24
+ * ModuleRegistry resolves any address to its module with lock free range lookup, GetRva uses containing module;
+ * 
+ * 2.6.23
+ * Module imports/exports are hashed on first query, delay load imports included, GetExportAddress;
+ * 
+ * 2.6.22
+ * PEImage maps an executable from disk for offline section, pattern and import queries;
+ * 
+ * 2.6.21
+ * Linux/ELF platform layer for module, patching and trampoline, include path case fixed;
+ * 
+ * 2.6.20
+ * Trampoline interns identical rel/vmt/iat thunks by content hash, shared blocks are reference counted;
+ * 
+ * 2.6.19
+ * Trampoline is a pool of regions, each hook allocates from the region nearest to its site;
+ * 
+ * 2.6.18
+ * Trampoline allocates from size class slabs with free lists, added deallocate and usage stats;
+ * Hook handles reserve their trampoline block upfront and return it on destruction if disabled;
+ * 
+ * 2.6.17
+ * Added InstallBatch, commits writes with other threads suspended and out of patched code;
+ * 
+ * 2.6.16
+ * Added PatchTransaction, trampoline writes skip protection changes;
+ * 
+ * 2.6.15
+ * GetDisp is decoder backed, resolves any rip displacement or relative branch;
+ * Added DecodeDisp and its batch form;
+ * 
+ * 2.6.14
+ * Added Disasm::relocate, cave hook stolen bytes are relocated into trampoline;
+ * 
+ * 2.6.13
+ * Added x86-64 length decoder Disasm::decode and AutoOffset helper;
+ * 
+ * 2.6.12
+ * Added consteval StaticPattern, compile time patterns use value/mask arrays and the simd scanner;
+ * 
+ * 2.6.11
+ * Added lazy search_all range, search_count and search_unique helpers;
+ * 
+ * 2.6.10
+ * Added SignatureCache, persistent pattern to RVA cache keyed by module version;
+ * 
+ * 2.6.9
+ * Added parallel search_pattern and search_all, chunked scan with std::execution::par;
+ * 
+ * 2.6.8
+ * Added PatternSet, resolves multiple patterns in a single pass;
+ * 
+ * 2.6.7
+ * Added SIMD version of search_pattern, runtime dispatched SSE2/AVX2 kernels;
+ * KMP version of search_pattern is kept as search_pattern_kmp;
+ * 
  * 2.6.6
  * Added KMP version of search_pattern.
  * 
@@ -110,21 +227,21 @@
 
 #define DKU_H_VERSION_MAJOR 2
 #define DKU_H_VERSION_MINOR 6
-#define DKU_H_VERSION_REVISION 4
+#define DKU_H_VERSION_REVISION 44
 
 #pragma warning(push)
 #pragma warning(disable: 4244)
 
-#include "Impl/pch.hpp"
+#include "Impl/PCH.hpp"
 
 namespace DKUtil
 {
 	constexpr auto DKU_H_VERSION = DKU_H_VERSION_MAJOR * 10000 + DKU_H_VERSION_MINOR * 100 + DKU_H_VERSION_REVISION;
 }  // namespace DKUtil
 
-#include "Impl/Hook/shared.hpp"
+#include "Impl/Hook/Shared.hpp"
 
-#include "Impl/Hook/api.hpp"
+#include "Impl/Hook/API.hpp"
 
 namespace DKUtil::Alias
 {
@@ -136,6 +253,7 @@ namespace DKUtil::Alias
 
 	using Reg = DKUtil::Hook::Assembly::Register;
 	using Xmm = DKUtil::Hook::Assembly::SIMD;
+	using Avx = DKUtil::Hook::Assembly::AVX;
 	template <class... Rules>
 	using Pattern = DKUtil::Hook::Assembly::Pattern::PatternMatcher<Rules...>;
 
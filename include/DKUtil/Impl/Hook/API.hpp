@@ -1,9 +1,12 @@
 #pragma once
 
-#include "assembly.hpp"
-#include "internal.hpp"
-#include "shared.hpp"
-#include "trampoline.hpp"
+#include "Assembly.hpp"
+#include "Internal.hpp"
+#include "PatternSet.hpp"
+#include "PEImage.hpp"
+#include "Shared.hpp"
+#include "SignatureCache.hpp"
+#include "Trampoline.hpp"
 
 namespace DKUtil::Hook
 {
@@ -90,21 +93,23 @@ namespace DKUtil::Hook
 	}
 
 	inline auto AddVMTHook(
-		void*                       a_vtbl,
-		const std::uint16_t         a_index,
-		const FuncInfo              a_funcInfo,
-		const Xbyak::CodeGenerator* a_xbyak) noexcept
+		void*                        a_vtbl,
+		const std::uint16_t          a_index,
+		const FuncInfo               a_funcInfo,
+		const Xbyak::CodeGenerator*  a_xbyak,
+		model::enumeration<HookFlag> a_flag = HookFlag::kNoFlag) noexcept
 	{
-		return AddVMTHook(a_vtbl, a_index, a_funcInfo, std::make_pair(a_xbyak->getCode(), a_xbyak->getSize()));
+		return AddVMTHook(a_vtbl, a_index, a_funcInfo, std::make_pair(a_xbyak->getCode(), a_xbyak->getSize()), a_flag);
 	}
 
 	inline auto AddVMTHook(
-		void*               a_vtbl,
-		const std::uint16_t a_index,
-		const FuncInfo      a_funcInfo,
-		const Patch*        a_patch) noexcept
+		void*                        a_vtbl,
+		const std::uint16_t          a_index,
+		const FuncInfo               a_funcInfo,
+		const Patch*                 a_patch,
+		model::enumeration<HookFlag> a_flag = HookFlag::kNoFlag) noexcept
 	{
-		return AddVMTHook(a_vtbl, a_index, a_funcInfo, std::make_pair(a_patch->Data, a_patch->Size));
+		return AddVMTHook(a_vtbl, a_index, a_funcInfo, std::make_pair(a_patch->Data, a_patch->Size), a_flag);
 	}
 
 	inline auto AddIATHook(
@@ -170,6 +175,7 @@ namespace DKUtil::Hook
 	 * \param a_dst : Destination function
 	 * \param a_regs : Regular registers to preserve as non volatile
 	 * \param a_simd : SSE registers to preserve as non volatile
+	 * \param a_avx : Vector width of a_simd and opmasks to preserve, or XSAVE for full extended state
 	 * \return F, the CaveHookHandle is discarded
 	 */
 	template <std::size_t N = 5, typename F>
@@ -177,9 +183,10 @@ namespace DKUtil::Hook
 		const std::uintptr_t  a_src,
 		F                     a_dst,
 		enumeration<Register> a_regs = { Register::NONE },
-		enumeration<SIMD>     a_simd = { SIMD::NONE }) noexcept
+		enumeration<SIMD>     a_simd = { SIMD::NONE },
+		enumeration<AVX>      a_avx = { AVX::NONE }) noexcept
 	{
-		dku_assert(a_regs.none(Register::NONE) || a_simd.none(SIMD::NONE),
+		dku_assert(a_regs.none(Register::NONE) || a_simd.none(SIMD::NONE) || a_avx.none(AVX::NONE),
 			"DKU_H: Cannot write_call_ex with empty flags");
 
 		// get original disp call
@@ -187,13 +194,11 @@ namespace DKUtil::Hook
 
 		// transform into CaveHook
 		auto [prolog1, epilog1] = JIT::MakeNonVolatilePatch(a_regs);
-		auto [prolog2, epilog2] = JIT::MakeNonVolatilePatch(a_simd);
+		auto [prolog2, epilog2] = JIT::MakeNonVolatilePatch(a_simd, a_avx);
 
-		// combine patches
-		if (prolog2.Data && epilog2.Data) {
-			prolog1.Append(prolog2);
-			epilog2.Append(epilog1);
-		}
+		// combine patches, register epilog is kept without simd patch
+		prolog1.Append(prolog2);
+		epilog2.Append(epilog1);
 
 		auto handle = AddCaveHook(
 			a_src,
@@ -205,4 +210,34 @@ namespace DKUtil::Hook
 
 		return std::bit_cast<F>(func);
 	}
+
+	/** \brief Relocate a callsite with target hook function
+	 * \brief This API preserves regular and sse registers across non-volatile call boundaries, the patch is generated at compile time
+	 * \param <N> : Length of source instruction
+	 * \param <Flags> : Register, SIMD and AVX values to preserve as non volatile
+	 * \param a_src : Address of call instruction
+	 * \param a_dst : Destination function
+	 * \return F, the CaveHookHandle is discarded
+	 */
+	template <std::size_t N = 5, auto... Flags, typename F>
+		requires(sizeof...(Flags) > 0)
+	inline auto write_call_ex(
+		const std::uintptr_t a_src,
+		F                    a_dst) noexcept
+	{
+		// get original disp call
+		auto func = GetDisp(a_src);
+
+		auto [prolog, epilog] = JIT::MakeNonVolatilePatch<Flags...>();
+
+		auto handle = AddCaveHook(
+			a_src,
+			{ 0, N },
+			RT_INFO(a_dst, fmt::format("write_call_ex<{}>", N)),
+			&prolog,
+			&epilog);
+		handle->Enable();
+
+		return std::bit_cast<F>(func);
+	}
 }  // namespace DKUtil::Hook
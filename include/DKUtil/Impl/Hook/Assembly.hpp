@@ -1,6 +1,23 @@
 #pragma once
 
-#include "shared.hpp"
+#include "Shared.hpp"
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#	define DKU_H_TARGET_AVX2
+#else
+#	include <cpuid.h>
+#	include <immintrin.h>
+#	define DKU_H_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#ifndef DKU_H_SCAN_MAX_THREADS
+#	define DKU_H_SCAN_MAX_THREADS 16
+#endif
+
+#ifndef DKU_H_SCAN_MIN_CHUNK
+#	define DKU_H_SCAN_MIN_CHUNK 0x100000
+#endif
 
 namespace DKUtil::Hook::Assembly
 {
@@ -8,6 +25,100 @@ namespace DKUtil::Hook::Assembly
 	constexpr OpCode INT3 = 0xCC;
 	constexpr OpCode RET = 0xC3;
 
+	namespace CPU
+	{
+		using cpuid_t = std::array<std::uint32_t, 4>;
+
+		[[nodiscard]] inline cpuid_t cpuid(std::uint32_t a_leaf, std::uint32_t a_subleaf = 0) noexcept
+		{
+			cpuid_t regs{};
+#if defined(_MSC_VER)
+			::__cpuidex(std::bit_cast<int*>(regs.data()), a_leaf, a_subleaf);
+#else
+			__cpuid_count(a_leaf, a_subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+			return regs;
+		}
+
+		[[nodiscard]] inline std::uint64_t xgetbv(std::uint32_t a_xcr = 0) noexcept
+		{
+#if defined(_MSC_VER)
+			return ::_xgetbv(a_xcr);
+#else
+			std::uint32_t lo, hi;
+			__asm__ volatile("xgetbv"
+							 : "=a"(lo), "=d"(hi)
+							 : "c"(a_xcr));
+			return static_cast<std::uint64_t>(hi) << 32 | lo;
+#endif
+		}
+
+		// state components enabled by os, 0 without xsave support
+		[[nodiscard]] inline std::uint64_t xcr0() noexcept
+		{
+			static const std::uint64_t xcr0 = (cpuid(1)[2] & (1u << 27)) ? xgetbv(0) : 0;
+			return xcr0;
+		}
+
+		// avx requires both cpu support and os enabled ymm state
+		[[nodiscard]] inline bool has_avx() noexcept
+		{
+			static const bool avx = (cpuid(1)[2] & (1u << 28)) && (xcr0() & 0x6) == 0x6;
+			return avx;
+		}
+
+		[[nodiscard]] inline bool has_avx2() noexcept
+		{
+			static const bool avx2 = has_avx() && cpuid(0)[0] >= 7 && (cpuid(7)[1] & (1u << 5));
+			return avx2;
+		}
+
+		// avx512f with os enabled opmask and zmm state
+		[[nodiscard]] inline bool has_avx512() noexcept
+		{
+			static const bool avx512 = has_avx() && cpuid(0)[0] >= 7 && (cpuid(7)[1] & (1u << 16)) && (xcr0() & 0xE0) == 0xE0;
+			return avx512;
+		}
+
+		// avx512bw widens opmasks to 64 bits, kmovq/kmovd need it, avx512f alone has 16 bit kmovw
+		[[nodiscard]] inline bool has_avx512bw() noexcept
+		{
+			static const bool avx512bw = has_avx512() && (cpuid(7)[1] & (1u << 30));
+			return avx512bw;
+		}
+
+		[[nodiscard]] inline bool has_xsavec() noexcept
+		{
+			static const bool xsavec = xcr0() && cpuid(0)[0] >= 0xD && (cpuid(0xD, 1)[0] & (1u << 1));
+			return xsavec;
+		}
+
+		/** \brief Bytes of xsave area for the state components
+		 * \param a_mask : State components, must be enabled in xcr0
+		 * \param a_compact : Compacted area of xsavec
+		 * \return std::uint32_t : area size, legacy region and header included
+		 */
+		[[nodiscard]] inline std::uint32_t xsave_size(std::uint64_t a_mask, bool a_compact) noexcept
+		{
+			std::uint32_t size = 0x240;
+			for (std::uint32_t i = 2; i < 63; ++i) {
+				if (!(a_mask & (1ull << i))) {
+					continue;
+				}
+
+				// eax size, ebx standard offset, ecx bit 1 aligned in compacted area
+				const auto leaf = cpuid(0xD, i);
+				if (a_compact) {
+					size = static_cast<std::uint32_t>(numbers::roundup(size, (leaf[2] & 0x2) ? 0x40 : 0x1)) + leaf[0];
+				} else {
+					size = (std::max)(size, leaf[1] + leaf[0]);
+				}
+			}
+
+			return size;
+		}
+	}  // namespace CPU
+
 	enum class Register : std::uint32_t
 	{
 		NONE = 1u << 0,
@@ -59,6 +170,19 @@ namespace DKUtil::Hook::Assembly
 		ALL = 1u << 17,
 	};
 
+	// extends SIMD preservation, widths are narrowed to what the os has enabled
+	// YMM and ZMM widen the requested xmm0-15 only, zmm16-31 are preserved by XSAVE
+	enum class AVX : std::uint32_t
+	{
+		NONE = 1u << 0,
+
+		YMM = 1u << 1,  // SIMD registers in ymm width, requires SIMD registers
+		ZMM = 1u << 2,  // SIMD registers in zmm width, requires SIMD registers
+		K = 1u << 3,    // opmask k0-k7
+
+		XSAVE = 1u << 4,  // full extended state with xsavec/xrstor, SIMD flags are ignored
+	};
+
 	namespace Pattern
 	{
 		namespace characters
@@ -269,9 +393,446 @@ namespace DKUtil::Hook::Assembly
 
 			return bytes;
 		}
+
+		/** \brief Non-owning value/mask view consumed by the vectorized scanner
+		 * \brief Value and mask are padded to 16 bytes, wildcards and padding have a zero mask
+		 * \brief Candidates are found from the rarest literal byte and filtered by the second rarest
+		 */
+		struct PatternView
+		{
+			const std::byte* value;
+			const std::byte* mask;
+			std::size_t      size;
+			std::size_t      padded;
+			std::size_t      anchor;
+			std::size_t      filter;
+		};
+
+		/** \brief Byte pattern compiled at runtime into value/mask vectors for the vectorized scanner
+		 */
+		struct CompiledPattern
+		{
+			static constexpr std::size_t BLOCK = 0x10;
+
+			std::vector<std::byte> value;
+			std::vector<std::byte> mask;
+			std::size_t            size{ 0 };
+			std::size_t            anchor{ 0 };
+			std::size_t            filter{ 0 };
+
+			[[nodiscard]] constexpr std::size_t padded() const noexcept { return value.size(); }
+
+			[[nodiscard]] constexpr operator PatternView() const noexcept
+			{
+				return { value.data(), mask.data(), size, padded(), anchor, filter };
+			}
+		};
+
+		// lower is rarer, roughly ordered by frequency in x64 code sections
+		[[nodiscard]] inline constexpr std::uint8_t byte_rank(std::byte a_byte) noexcept
+		{
+			constexpr auto lut = []() noexcept {
+				constexpr std::uint8_t common[] = {
+					0x00, 0xFF, 0x48, 0xCC, 0x8B, 0x89, 0x24, 0x0F, 0x4C, 0x01, 0xE8, 0x44, 0x8D, 0x83, 0x20, 0x08,
+					0x10, 0x40, 0x85, 0x74, 0xC3, 0x45, 0x4D, 0x49, 0x41, 0x18, 0x30, 0x28, 0x84, 0xC0, 0x75, 0x02,
+					0x04, 0x50, 0x38, 0x90, 0x5C, 0x33, 0x54, 0xEB, 0x03, 0x0D, 0x05, 0xC7, 0xE9, 0x80, 0x8E, 0x15
+				};
+
+				std::array<std::uint8_t, std::numeric_limits<unsigned char>::max() + 1> a{};
+				for (std::size_t i = 0; i < std::extent_v<decltype(common)>; ++i) {
+					a[common[i]] = static_cast<std::uint8_t>(std::extent_v<decltype(common)> - i);
+				}
+
+				return a;
+			}();
+
+			return lut[std::to_integer<std::uint8_t>(a_byte)];
+		}
+
+		// offsets of the rarest and second rarest literal bytes
+		[[nodiscard]] inline constexpr std::pair<std::size_t, std::size_t> select_anchors(const std::byte* a_value, const std::byte* a_mask, std::size_t a_size) noexcept
+		{
+			std::size_t   anchor = 0;
+			std::size_t   filter = 0;
+			std::uint16_t anchorRank = std::numeric_limits<std::uint16_t>::max();
+			std::uint16_t filterRank = std::numeric_limits<std::uint16_t>::max();
+			for (std::size_t i = 0; i < a_size; ++i) {
+				if (a_mask[i] == WILDCARD) {
+					continue;
+				}
+
+				const std::uint16_t rank = byte_rank(a_value[i]);
+				if (rank < anchorRank) {
+					filter = anchor;
+					filterRank = anchorRank;
+					anchor = i;
+					anchorRank = rank;
+				} else if (rank < filterRank) {
+					filter = i;
+					filterRank = rank;
+				}
+			}
+
+			// single literal byte
+			if (filterRank == std::numeric_limits<std::uint16_t>::max()) {
+				filter = anchor;
+			}
+
+			return { anchor, filter };
+		}
+
+		[[nodiscard]] inline CompiledPattern compile(std::span<const ByteMatch> a_bytes) noexcept
+		{
+			CompiledPattern pattern;
+			pattern.size = a_bytes.size();
+
+			const auto padded = numbers::roundup(pattern.size, CompiledPattern::BLOCK);
+			pattern.value.resize(padded, WILDCARD);
+			pattern.mask.resize(padded, WILDCARD);
+
+			for (std::size_t i = 0; i < a_bytes.size(); ++i) {
+				if (!a_bytes[i].wildcard) {
+					pattern.value[i] = a_bytes[i].hex;
+					pattern.mask[i] = std::byte{ 0xFF };
+				}
+			}
+
+			std::tie(pattern.anchor, pattern.filter) = select_anchors(pattern.value.data(), pattern.mask.data(), pattern.size);
+
+			return pattern;
+		}
+
+		[[nodiscard]] inline CompiledPattern compile(std::string_view a_pattern)
+		{
+			return compile(make_byte_matches(sanitize(a_pattern)));
+		}
+
+		/** \brief Byte pattern compiled at compile time into fixed value/mask arrays
+		 * \brief Converts to the same view as CompiledPattern, so it takes the vectorized scanner without runtime parsing
+		 * \brief The Horspool skip table drives find(), which is also usable in constant evaluation
+		 */
+		template <std::size_t N>
+		struct StaticPattern
+		{
+			static constexpr std::size_t PADDED = numbers::roundup(N, CompiledPattern::BLOCK);
+
+			std::array<std::byte, PADDED>  value{};
+			std::array<std::byte, PADDED>  mask{};
+			std::array<std::size_t, 0x100> skip{};
+			std::size_t                    anchor{ 0 };
+			std::size_t                    filter{ 0 };
+
+			[[nodiscard]] static consteval std::size_t size() noexcept { return N; }
+
+			[[nodiscard]] constexpr bool match(std::span<const std::byte, N> a_bytes) const noexcept
+			{
+				for (std::size_t i = 0; i < N; ++i) {
+					if ((a_bytes[i] & mask[i]) != value[i]) {
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+			[[nodiscard]] constexpr const std::byte* find(const std::byte* a_begin, const std::byte* a_end) const noexcept
+			{
+				const auto size = static_cast<std::size_t>(a_end - a_begin);
+				for (std::size_t i = 0; i + N <= size; i += skip[std::to_integer<std::uint8_t>(a_begin[i + N - 1])]) {
+					if (match(std::span<const std::byte, N>{ a_begin + i, N })) {
+						return a_begin + i;
+					}
+				}
+
+				return nullptr;
+			}
+
+			[[nodiscard]] constexpr operator PatternView() const noexcept
+			{
+				return { value.data(), mask.data(), N, PADDED, anchor, filter };
+			}
+		};
+
+		template <string::static_string S>
+		[[nodiscard]] consteval std::size_t static_pattern_size() noexcept
+		{
+			std::size_t size = 0;
+			for (std::size_t i = 0; i < S.length();) {
+				if (characters::whitespace(S[i])) {
+					++i;
+					continue;
+				}
+
+				if (i + 1 == S.length() || characters::whitespace(S[i + 1])) {
+					consteval_error("the given pattern has an unpaired rule (rules are required to be written in pairs of 2)");
+				} else if (!(characters::hexadecimal(S[i]) && characters::hexadecimal(S[i + 1])) &&
+						   !(characters::wildcard(S[i]) && characters::wildcard(S[i + 1]))) {
+					consteval_error("the given pattern failed to match any known rules");
+				} else if (!size && characters::wildcard(S[i])) {
+					consteval_error("the given pattern can't begin with wildcards");
+				}
+
+				++size;
+				i += 2;
+			}
+
+			if (!size) {
+				consteval_error("must provide at least 1 rule for the pattern");
+			}
+
+			return size;
+		}
+
+		/** \brief Compile a hex string pattern into value/mask arrays and skip table at compile time.
+		 * \brief Same syntax as search_pattern, spacing is optional.
+		 */
+		template <string::static_string S>
+		[[nodiscard]] consteval auto make_static_pattern() noexcept
+		{
+			constexpr auto   N = static_pattern_size<S>();
+			StaticPattern<N> pattern{};
+
+			for (std::size_t i = 0, c = 0; c < S.length();) {
+				if (characters::whitespace(S[c])) {
+					++c;
+					continue;
+				}
+
+				if (!characters::wildcard(S[c])) {
+					pattern.value[i] = rules::hexachar_to_hexadec(S[c], S[c + 1]);
+					pattern.mask[i] = std::byte{ 0xFF };
+				}
+
+				++i;
+				c += 2;
+			}
+
+			std::tie(pattern.anchor, pattern.filter) = select_anchors(pattern.value.data(), pattern.mask.data(), N);
+
+			// shift by distance from the last occurrence before the final byte, a wildcard matches any byte
+			pattern.skip.fill(N);
+			for (std::size_t i = 0; i + 1 < N; ++i) {
+				if (pattern.mask[i] == WILDCARD) {
+					pattern.skip.fill(N - 1 - i);
+				} else {
+					pattern.skip[std::to_integer<std::uint8_t>(pattern.value[i])] = N - 1 - i;
+				}
+			}
+
+			return pattern;
+		}
+
+		template <string::static_string S>
+		inline constexpr auto static_pattern = make_static_pattern<S>();
+
+		namespace detail
+		{
+			using scan_kernel = const std::byte* (*)(const std::byte*, const std::byte*, const PatternView&) noexcept;
+
+			[[nodiscard]] inline bool verify_scalar(const std::byte* a_mem, const PatternView& a_pattern) noexcept
+			{
+				std::size_t i = 0;
+				for (; i + sizeof(Imm64) <= a_pattern.size; i += sizeof(Imm64)) {
+					Imm64 mem, value, mask;
+					std::memcpy(&mem, a_mem + i, sizeof(Imm64));
+					std::memcpy(&value, a_pattern.value + i, sizeof(Imm64));
+					std::memcpy(&mask, a_pattern.mask + i, sizeof(Imm64));
+					if ((mem & mask) != value) {
+						return false;
+					}
+				}
+
+				for (; i < a_pattern.size; ++i) {
+					if ((a_mem[i] & a_pattern.mask[i]) != a_pattern.value[i]) {
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+			// reads whole 16 byte blocks when the padded pattern stays within bound
+			[[nodiscard]] inline bool verify_sse2(const std::byte* a_mem, const std::byte* a_end, const PatternView& a_pattern) noexcept
+			{
+				if (a_mem + a_pattern.padded > a_end) {
+					return verify_scalar(a_mem, a_pattern);
+				}
+
+				for (std::size_t i = 0; i < a_pattern.padded; i += CompiledPattern::BLOCK) {
+					const auto mem = _mm_loadu_si128(std::bit_cast<const __m128i*>(a_mem + i));
+					const auto value = _mm_loadu_si128(std::bit_cast<const __m128i*>(a_pattern.value + i));
+					const auto mask = _mm_loadu_si128(std::bit_cast<const __m128i*>(a_pattern.mask + i));
+					if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(mem, mask), value)) != 0xFFFF) {
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+			[[nodiscard]] inline const std::byte* scan_tail(const std::byte* a_mem, const std::byte* a_last, const std::byte* a_end, const PatternView& a_pattern) noexcept
+			{
+				const auto anchor = a_pattern.value[a_pattern.anchor];
+				for (; a_mem <= a_last; ++a_mem) {
+					if (a_mem[a_pattern.anchor] == anchor && verify_sse2(a_mem, a_end, a_pattern)) {
+						return a_mem;
+					}
+				}
+
+				return nullptr;
+			}
+
+			[[nodiscard]] inline const std::byte* scan_sse2(const std::byte* a_begin, const std::byte* a_end, const PatternView& a_pattern) noexcept
+			{
+				constexpr std::size_t STRIDE = sizeof(__m128i);
+
+				const auto* last = a_end - a_pattern.size;
+				const auto  anchor = _mm_set1_epi8(std::to_integer<char>(a_pattern.value[a_pattern.anchor]));
+				const auto  filter = _mm_set1_epi8(std::to_integer<char>(a_pattern.value[a_pattern.filter]));
+
+				auto* mem = a_begin;
+				for (; last - mem >= static_cast<std::ptrdiff_t>(STRIDE - 1); mem += STRIDE) {
+					const auto a = _mm_cmpeq_epi8(anchor, _mm_loadu_si128(std::bit_cast<const __m128i*>(mem + a_pattern.anchor)));
+					const auto f = _mm_cmpeq_epi8(filter, _mm_loadu_si128(std::bit_cast<const __m128i*>(mem + a_pattern.filter)));
+
+					auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(a, f)));
+					while (bits) {
+						const auto* candidate = mem + std::countr_zero(bits);
+						if (verify_sse2(candidate, a_end, a_pattern)) {
+							return candidate;
+						}
+						bits &= bits - 1;
+					}
+				}
+
+				return scan_tail(mem, last, a_end, a_pattern);
+			}
+
+			[[nodiscard]] DKU_H_TARGET_AVX2 inline const std::byte* scan_avx2(const std::byte* a_begin, const std::byte* a_end, const PatternView& a_pattern) noexcept
+			{
+				constexpr std::size_t STRIDE = sizeof(__m256i);
+
+				const auto* last = a_end - a_pattern.size;
+				const auto  anchor = _mm256_set1_epi8(std::to_integer<char>(a_pattern.value[a_pattern.anchor]));
+				const auto  filter = _mm256_set1_epi8(std::to_integer<char>(a_pattern.value[a_pattern.filter]));
+
+				auto* mem = a_begin;
+				for (; last - mem >= static_cast<std::ptrdiff_t>(STRIDE - 1); mem += STRIDE) {
+					const auto a = _mm256_cmpeq_epi8(anchor, _mm256_loadu_si256(std::bit_cast<const __m256i*>(mem + a_pattern.anchor)));
+					const auto f = _mm256_cmpeq_epi8(filter, _mm256_loadu_si256(std::bit_cast<const __m256i*>(mem + a_pattern.filter)));
+
+					auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(a, f)));
+					while (bits) {
+						const auto* candidate = mem + std::countr_zero(bits);
+						if (verify_sse2(candidate, a_end, a_pattern)) {
+							return candidate;
+						}
+						bits &= bits - 1;
+					}
+				}
+
+				return scan_tail(mem, last, a_end, a_pattern);
+			}
+
+			[[nodiscard]] inline scan_kernel get_kernel() noexcept
+			{
+				static const scan_kernel kernel = CPU::has_avx2() ? scan_avx2 : scan_sse2;
+				return kernel;
+			}
+		}  // namespace detail
+
+		/** \brief Vectorized search of a compiled pattern in [a_begin, a_end)
+		 * \return const std::byte* : pointer of first match, nullptr if none found.
+		 */
+		[[nodiscard]] inline const std::byte* scan(const std::byte* a_begin, const std::byte* a_end, const PatternView& a_pattern) noexcept
+		{
+			if (!a_pattern.size || a_end - a_begin < static_cast<std::ptrdiff_t>(a_pattern.size)) {
+				return nullptr;
+			}
+
+			return detail::get_kernel()(a_begin, a_end, a_pattern);
+		}
+
+		namespace detail
+		{
+			[[nodiscard]] inline std::size_t scan_threads() noexcept
+			{
+				return std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, DKU_H_SCAN_MAX_THREADS);
+			}
+
+			// workers live for the duration of one scan, no thread is left behind to join at module unload
+			template <typename Fn>
+			inline void parallel_for(std::size_t a_count, Fn&& a_fn)
+			{
+				std::atomic<std::size_t> next{ 0 };
+				auto                     drain = [&]() {
+					for (auto i = next++; i < a_count; i = next++) {
+						a_fn(i);
+					}
+				};
+
+				std::vector<std::jthread> workers;
+				for (std::size_t i = 1; i < std::min(a_count, scan_threads()); ++i) {
+					workers.emplace_back(drain);
+				}
+
+				drain();
+			}
+
+			/** \brief Split [a_begin, a_end) into chunks overlapping by pattern size - 1 and scan them in parallel.
+			 * \brief A match belongs to the chunk it starts in, so overlaps never report duplicates.
+			 * \return Matches in ascending address order, only the lowest one unless a_all.
+			 */
+			[[nodiscard]] inline std::vector<const std::byte*> scan_chunks(const std::byte* a_begin, const std::byte* a_end, const PatternView& a_pattern, bool a_all)
+			{
+				if (!a_pattern.size || a_end - a_begin < static_cast<std::ptrdiff_t>(a_pattern.size)) {
+					return {};
+				}
+
+				const std::size_t size = a_end - a_begin;
+				const std::size_t chunk = std::max<std::size_t>(DKU_H_SCAN_MIN_CHUNK, numbers::roundup(size / (scan_threads() * 4) + 1, 0x1000));
+				const std::size_t count = (size + chunk - 1) / chunk;
+
+				std::vector<std::vector<const std::byte*>> results(count);
+				std::atomic<std::size_t>                   first{ count };
+
+				parallel_for(count, [&](std::size_t a_index) {
+					// a lower chunk already matched
+					if (!a_all && a_index > first.load(std::memory_order_relaxed)) {
+						return;
+					}
+
+					const auto  offset = a_index * chunk;
+					const auto* lo = a_begin + offset;
+					const auto* own = a_begin + std::min(offset + chunk, size);
+					const auto* hi = a_begin + std::min(offset + chunk + a_pattern.size - 1, size);
+
+					for (auto* mem = scan(lo, hi, a_pattern); mem && mem < own; mem = scan(mem + 1, hi, a_pattern)) {
+						results[a_index].push_back(mem);
+
+						if (!a_all) {
+							auto expected = first.load();
+							while (a_index < expected && !first.compare_exchange_weak(expected, a_index)) {}
+							break;
+						}
+					}
+				});
+
+				std::vector<const std::byte*> matches;
+				for (auto& result : results) {
+					matches.insert(matches.end(), result.begin(), result.end());
+					if (!a_all && !matches.empty()) {
+						break;
+					}
+				}
+
+				return matches;
+			}
+		}  // namespace detail
 	}  // namespace detail
 
-	/** \brief Search a byte pattern in memory, kmp.
+	/** \brief Search a byte pattern in memory, simd.
+	 * \brief AVX2 kernel is dispatched at runtime, SSE2 otherwise.
 	 * \param a_pattern : hex string pattern of bytes. Spacing is optional. e.g. "FF 15 ????????".
 	 * \param a_base : base address of memory block to search, default to module textx section.
 	 * \param a_size : size of memory block to search, default to module textx size.
@@ -294,6 +855,233 @@ namespace DKUtil::Hook::Assembly
 			a_size = size;
 		}
 
+		const auto* begin = static_cast<const std::byte*>(AsPointer(base));
+		const auto  pattern = Pattern::compile(a_pattern);
+
+		return const_cast<std::byte*>(Pattern::scan(begin, begin + a_size, pattern));
+	}
+
+	/** \brief Search a byte pattern in memory, parallel simd.
+	 * \brief Memory block is split into overlapping chunks scanned on up to DKU_H_SCAN_MAX_THREADS threads.
+	 * \param a_pattern : hex string pattern of bytes. Spacing is optional. e.g. "FF 15 ????????".
+	 * \param a_base : base address of memory block to search, default to module textx section.
+	 * \param a_size : size of memory block to search, default to module textx size.
+	 * \return void* : pointer of first match with the lowest address, nullptr if none found.
+	 */
+	[[nodiscard]] inline std::byte* search_pattern(
+		const std::execution::parallel_policy&,
+		std::string_view                 a_pattern,
+		model::concepts::dku_memory auto a_base = 0,
+		std::size_t                      a_size = 0)
+	{
+		std::uintptr_t base{ AsAddress(a_base) };
+
+		auto [textx, size] = Module::get().section(Module::Section::textx);
+
+		if (!base) {
+			base = textx;
+		}
+
+		if (!a_size) {
+			a_size = size;
+		}
+
+		const auto* begin = static_cast<const std::byte*>(AsPointer(base));
+		const auto  matches = Pattern::detail::scan_chunks(begin, begin + a_size, Pattern::compile(a_pattern), false);
+
+		return matches.empty() ? nullptr : const_cast<std::byte*>(matches.front());
+	}
+
+	/** \brief Search all matches of a byte pattern in memory, parallel simd.
+	 * \param a_pattern : hex string pattern of bytes. Spacing is optional. e.g. "FF 15 ????????".
+	 * \param a_base : base address of memory block to search, default to module textx section.
+	 * \param a_size : size of memory block to search, default to module textx size.
+	 * \return std::vector<std::byte*> : all matches in ascending address order.
+	 */
+	[[nodiscard]] inline std::vector<std::byte*> search_all(
+		const std::execution::parallel_policy&,
+		std::string_view                 a_pattern,
+		model::concepts::dku_memory auto a_base = 0,
+		std::size_t                      a_size = 0)
+	{
+		std::uintptr_t base{ AsAddress(a_base) };
+
+		auto [textx, size] = Module::get().section(Module::Section::textx);
+
+		if (!base) {
+			base = textx;
+		}
+
+		if (!a_size) {
+			a_size = size;
+		}
+
+		const auto* begin = static_cast<const std::byte*>(AsPointer(base));
+		const auto  matches = Pattern::detail::scan_chunks(begin, begin + a_size, Pattern::compile(a_pattern), true);
+
+		std::vector<std::byte*> result(matches.size());
+		std::ranges::transform(matches, result.begin(), [](const std::byte* a_match) { return const_cast<std::byte*>(a_match); });
+
+		return result;
+	}
+
+	/** \brief Lazy range of all matches of a compiled pattern, in ascending address order.
+	 * \brief Pattern is compiled once on construction, each increment resumes the scan after the previous match.
+	 * \brief The range must outlive its iterators.
+	 */
+	class MatchRange : public std::ranges::view_interface<MatchRange>
+	{
+	public:
+		class iterator
+		{
+		public:
+			using value_type = std::byte*;
+			using difference_type = std::ptrdiff_t;
+			using iterator_concept = std::forward_iterator_tag;
+
+			constexpr iterator() noexcept = default;
+			constexpr iterator(const MatchRange* a_range, const std::byte* a_match) noexcept :
+				_range(a_range), _match(a_match)
+			{}
+
+			[[nodiscard]] value_type operator*() const noexcept { return const_cast<std::byte*>(_match); }
+
+			iterator& operator++() noexcept
+			{
+				_match = Pattern::scan(_match + 1, _range->_end, _range->_pattern);
+				return *this;
+			}
+
+			iterator operator++(int) noexcept
+			{
+				auto prev = *this;
+				++*this;
+				return prev;
+			}
+
+			[[nodiscard]] constexpr bool operator==(const iterator& a_rhs) const noexcept { return _match == a_rhs._match; }
+			[[nodiscard]] constexpr bool operator==(std::default_sentinel_t) const noexcept { return !_match; }
+
+		private:
+			const MatchRange* _range{ nullptr };
+			const std::byte*  _match{ nullptr };
+		};
+
+		MatchRange() = default;
+		MatchRange(Pattern::CompiledPattern a_pattern, const std::byte* a_begin, const std::byte* a_end) noexcept :
+			_pattern(std::move(a_pattern)), _begin(a_begin), _end(a_end)
+		{}
+
+		[[nodiscard]] iterator begin() const noexcept { return { this, Pattern::scan(_begin, _end, _pattern) }; }
+		[[nodiscard]] constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+		/** \brief Count matches, stops scanning once a_limit is reached.
+		 */
+		[[nodiscard]] std::size_t count(std::size_t a_limit = std::numeric_limits<std::size_t>::max()) const noexcept
+		{
+			std::size_t total{ 0 };
+			for (auto it = begin(); it != end() && total < a_limit; ++it) {
+				++total;
+			}
+
+			return total;
+		}
+
+		/** \brief Get the only match, stops scanning after the second match.
+		 * \return std::byte* : the match if unique, nullptr if none or multiple found.
+		 */
+		[[nodiscard]] std::byte* unique() const noexcept
+		{
+			auto it = begin();
+			if (it == end()) {
+				return nullptr;
+			}
+
+			auto* match = *it;
+			return ++it == end() ? match : nullptr;
+		}
+
+	private:
+		Pattern::CompiledPattern _pattern{};
+		const std::byte*         _begin{ nullptr };
+		const std::byte*         _end{ nullptr };
+	};
+
+	/** \brief Search all matches of a byte pattern in memory, lazily.
+	 * \param a_pattern : hex string pattern of bytes. Spacing is optional. e.g. "FF 15 ????????".
+	 * \param a_base : base address of memory block to search, default to module textx section.
+	 * \param a_size : size of memory block to search, default to module textx size.
+	 * \return MatchRange : forward range of std::byte*, the next match is scanned on increment.
+	 */
+	[[nodiscard]] inline MatchRange search_all(
+		std::string_view                 a_pattern,
+		model::concepts::dku_memory auto a_base = 0,
+		std::size_t                      a_size = 0)
+	{
+		std::uintptr_t base{ AsAddress(a_base) };
+
+		auto [textx, size] = Module::get().section(Module::Section::textx);
+
+		if (!base) {
+			base = textx;
+		}
+
+		if (!a_size) {
+			a_size = size;
+		}
+
+		const auto* begin = static_cast<const std::byte*>(AsPointer(base));
+		return { Pattern::compile(a_pattern), begin, begin + a_size };
+	}
+
+	/** \brief Count matches of a byte pattern in memory.
+	 * \param a_limit : stop scanning once this many matches are found.
+	 * \return std::size_t : number of matches, at most a_limit.
+	 */
+	[[nodiscard]] inline std::size_t search_count(
+		std::string_view                 a_pattern,
+		model::concepts::dku_memory auto a_base = 0,
+		std::size_t                      a_size = 0,
+		std::size_t                      a_limit = std::numeric_limits<std::size_t>::max())
+	{
+		return search_all(a_pattern, a_base, a_size).count(a_limit);
+	}
+
+	/** \brief Search a byte pattern that must be unique in memory, stops after the second match.
+	 * \return std::byte* : the match if unique, nullptr if none or multiple found.
+	 */
+	[[nodiscard]] inline std::byte* search_unique(
+		std::string_view                 a_pattern,
+		model::concepts::dku_memory auto a_base = 0,
+		std::size_t                      a_size = 0)
+	{
+		return search_all(a_pattern, a_base, a_size).unique();
+	}
+
+	/** \brief Search a byte pattern in memory, kmp.
+	 * \brief Reference implementation of search_pattern, kept for validation and benchmarking.
+	 * \param a_pattern : hex string pattern of bytes. Spacing is optional. e.g. "FF 15 ????????".
+	 * \param a_base : base address of memory block to search, default to module textx section.
+	 * \param a_size : size of memory block to search, default to module textx size.
+	 * \return void* : pointer of first match, nullptr if none found.
+	 */
+	[[nodiscard]] inline std::byte* search_pattern_kmp(
+		std::string_view                 a_pattern,
+		model::concepts::dku_memory auto a_base = 0,
+		std::size_t                      a_size = 0)
+	{
+		std::uintptr_t base{ AsAddress(a_base) };
+
+		auto [textx, size] = Module::get().section(Module::Section::textx);
+
+		if (!base) {
+			base = textx;
+		}
+
+		if (!a_size) {
+			a_size = size;
+		}
+
 		auto* begin = static_cast<std::byte*>(AsPointer(base));
 		auto* end = adjust_pointer(begin, a_size);
 		auto  bytes = Pattern::make_byte_matches(Pattern::sanitize(a_pattern));
@@ -385,8 +1173,8 @@ namespace DKUtil::Hook::Assembly
 		return nullptr;
 	}
 
-	/** \brief Search a byte pattern in memory, linear.
-	 * \brief To use pattern as argument, use search_pattern<T>(pattern) instead.
+	/** \brief Search a compile time byte pattern in memory, simd.
+	 * \brief Pattern is compiled into value/mask arrays at compile time, there is no parsing at runtime.
 	 * \param a_base : base address of memory block to search, default to module textx section.
 	 * \param a_size : size of memory block to search, default to module textx size.
 	 * \return void* : pointer of first match, nullptr if none found.
@@ -394,6 +1182,18 @@ namespace DKUtil::Hook::Assembly
 	template <string::static_string S>
 	[[nodiscard]] inline void* search_pattern(std::uintptr_t a_base = 0, std::size_t a_size = 0) noexcept
 	{
-		return search_pattern<Pattern::do_make_pattern<S>()>();
+		auto [textx, size] = Module::get().section(Hook::Module::Section::textx);
+
+		if (!a_base) {
+			a_base = textx;
+		}
+
+		if (!a_size) {
+			a_size = size;
+		}
+
+		const auto* begin = static_cast<const std::byte*>(AsPointer(a_base));
+
+		return const_cast<std::byte*>(Pattern::scan(begin, begin + a_size, Pattern::static_pattern<S>));
 	}
 }  // namespace DKUtil::Hook::Assembly
@@ -0,0 +1,714 @@
+#pragma once
+
+// standalone, only depends on the standard library so it can be tested on any platform
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DKUtil::Hook::Disasm
+{
+	inline constexpr std::size_t MAX_LENGTH = 15;
+
+	/** \brief Decoded layout of one x86-64 instruction, offsets are relative to the first byte
+	 * \brief An instruction that failed to decode has a length of 0
+	 */
+	struct Instruction
+	{
+		enum Flag : std::uint16_t
+		{
+			kNone = 0,
+
+			kOpSize = 1u << 0,       // 66
+			kAddrSize = 1u << 1,     // 67
+			kLock = 1u << 2,         // F0
+			kRepne = 1u << 3,        // F2
+			kRep = 1u << 4,          // F3
+			kSegment = 1u << 5,      // 26 2E 36 3E 64 65
+			kRex = 1u << 6,          // 40-4F
+			kVex = 1u << 7,          // C4 C5
+			kEvex = 1u << 8,         // 62
+			kXop = 1u << 9,          // 8F
+			kRipRelative = 1u << 10, // [rip + disp32] memory operand
+			kRelative = 1u << 11,    // branch, immediate is rel8/rel32
+		};
+
+		[[nodiscard]] constexpr bool valid() const noexcept { return length; }
+		[[nodiscard]] constexpr bool rip_relative() const noexcept { return flags & kRipRelative; }
+		[[nodiscard]] constexpr bool relative() const noexcept { return flags & kRelative; }
+		[[nodiscard]] constexpr bool rex_w() const noexcept { return rex & 0x08; }
+
+		/** \brief Absolute address referenced by rip relative operand or relative branch.
+		 * \param a_address : address this instruction is located at.
+		 * \return std::uintptr_t : target address, 0 if the instruction is neither.
+		 */
+		[[nodiscard]] constexpr std::uintptr_t target(std::uintptr_t a_address) const noexcept
+		{
+			if (rip_relative()) {
+				return a_address + length + disp;
+			} else if (relative()) {
+				return a_address + length + imm;
+			} else {
+				return 0;
+			}
+		}
+
+		std::int64_t  imm{ 0 };  // sign extended for relative branches
+		std::int32_t  disp{ 0 };
+		std::uint16_t flags{ kNone };
+		std::uint8_t  length{ 0 };
+		std::uint8_t  map{ 0 };  // 0 one byte, 1 0F, 2 0F38, 3 0F3A, 5-6 EVEX, 8-A XOP
+		std::uint8_t  opcode{ 0 };
+		std::uint8_t  opcodeOffset{ 0 };
+		std::uint8_t  rex{ 0 };
+		std::uint8_t  modrm{ 0 };
+		std::uint8_t  modrmOffset{ 0 };
+		std::uint8_t  dispOffset{ 0 };
+		std::uint8_t  dispSize{ 0 };
+		std::uint8_t  immOffset{ 0 };
+		std::uint8_t  immSize{ 0 };
+	};
+
+	namespace detail
+	{
+		enum OpFlag : std::uint8_t
+		{
+			kNone = 0,
+			kModRM = 1u << 0,
+			kImm8 = 1u << 1,
+			kImm16 = 1u << 2,
+			kImmZ = 1u << 3,    // imm16/32 by operand size
+			kImmV = 1u << 4,    // imm16/32/64 by operand size
+			kRel = 1u << 5,     // immediate is a branch displacement
+			kMoffs = 1u << 6,   // address sized absolute offset
+			kInvalid = 1u << 7  // invalid in 64-bit mode, or consumed as prefix/escape
+		};
+
+		inline constexpr std::uint8_t N = kNone;
+		inline constexpr std::uint8_t M = kModRM;
+		inline constexpr std::uint8_t MB = kModRM | kImm8;
+		inline constexpr std::uint8_t MZ = kModRM | kImmZ;
+		inline constexpr std::uint8_t B = kImm8;
+		inline constexpr std::uint8_t W = kImm16;
+		inline constexpr std::uint8_t WB = kImm16 | kImm8;
+		inline constexpr std::uint8_t Z = kImmZ;
+		inline constexpr std::uint8_t V = kImmV;
+		inline constexpr std::uint8_t JB = kRel | kImm8;
+		inline constexpr std::uint8_t JZ = kRel | kImmZ;
+		inline constexpr std::uint8_t O = kMoffs;
+		inline constexpr std::uint8_t X = kInvalid;
+
+		// clang-format off
+		inline constexpr std::array<std::uint8_t, 0x100> OPCODE_MAP_1 = {
+			//  0   1   2   3   4   5   6   7   8   9   A   B   C   D   E   F
+			    M,  M,  M,  M,  B,  Z,  X,  X,  M,  M,  M,  M,  B,  Z,  X,  X,  // 0
+			    M,  M,  M,  M,  B,  Z,  X,  X,  M,  M,  M,  M,  B,  Z,  X,  X,  // 1
+			    M,  M,  M,  M,  B,  Z,  X,  X,  M,  M,  M,  M,  B,  Z,  X,  X,  // 2
+			    M,  M,  M,  M,  B,  Z,  X,  X,  M,  M,  M,  M,  B,  Z,  X,  X,  // 3
+			    X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  X,  // 4
+			    N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  // 5
+			    X,  X,  X,  M,  X,  X,  X,  X,  Z, MZ,  B, MB,  N,  N,  N,  N,  // 6
+			   JB, JB, JB, JB, JB, JB, JB, JB, JB, JB, JB, JB, JB, JB, JB, JB,  // 7
+			   MB, MZ,  X, MB,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  // 8
+			    N,  N,  N,  N,  N,  N,  N,  N,  N,  N,  X,  N,  N,  N,  N,  N,  // 9
+			    O,  O,  O,  O,  N,  N,  N,  N,  B,  Z,  N,  N,  N,  N,  N,  N,  // A
+			    B,  B,  B,  B,  B,  B,  B,  B,  V,  V,  V,  V,  V,  V,  V,  V,  // B
+			   MB, MB,  W,  N,  X,  X, MB, MZ, WB,  N,  W,  N,  N,  B,  X,  N,  // C
+			    M,  M,  M,  M,  X,  X,  X,  N,  M,  M,  M,  M,  M,  M,  M,  M,  // D
+			   JB, JB, JB, JB,  B,  B,  B,  B, JZ, JZ,  X, JB,  N,  N,  N,  N,  // E
+			    X,  N,  X,  X,  N,  N,  M,  M,  N,  N,  N,  N,  N,  N,  M,  M,  // F
+		};
+
+		inline constexpr std::array<std::uint8_t, 0x100> OPCODE_MAP_0F = {
+			//  0   1   2   3   4   5   6   7   8   9   A   B   C   D   E   F
+			    M,  M,  M,  M,  X,  N,  N,  N,  N,  N,  X,  N,  X,  M,  N, MB,  // 0
+			    M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  // 1
+			    M,  M,  M,  M,  X,  X,  X,  X,  M,  M,  M,  M,  M,  M,  M,  M,  // 2
+			    N,  N,  N,  N,  N,  N,  X,  N,  X,  X,  X,  X,  X,  X,  X,  X,  // 3
+			    M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  // 4
+			    M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  // 5
+			    M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  // 6
+			   MB, MB, MB, MB,  M,  M,  M,  N,  M,  M,  X,  X,  M,  M,  M,  M,  // 7
+			   JZ, JZ, JZ, JZ, JZ, JZ, JZ, JZ, JZ, JZ, JZ, JZ, JZ, JZ, JZ, JZ,  // 8
+			    M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  // 9
+			    N,  N,  N,  M, MB,  M,  X,  X,  N,  N,  N,  M, MB,  M,  M,  M,  // A
+			    M,  M,  M,  M,  M,  M,  M,  M,  M,  M, MB,  M,  M,  M,  M,  M,  // B
+			    M,  M, MB,  M, MB, MB, MB,  M,  N,  N,  N,  N,  N,  N,  N,  N,  // C
+			    M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  // D
+			    M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  // E
+			    M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  M,  // F
+		};
+		// clang-format on
+
+		[[nodiscard]] inline constexpr bool is_legacy_prefix(std::uint8_t a_byte, std::uint16_t& a_flags) noexcept
+		{
+			switch (a_byte) {
+			case 0x66:
+				a_flags |= Instruction::kOpSize;
+				return true;
+			case 0x67:
+				a_flags |= Instruction::kAddrSize;
+				return true;
+			case 0xF0:
+				a_flags |= Instruction::kLock;
+				return true;
+			case 0xF2:
+				a_flags |= Instruction::kRepne;
+				return true;
+			case 0xF3:
+				a_flags |= Instruction::kRep;
+				return true;
+			case 0x26:
+			case 0x2E:
+			case 0x36:
+			case 0x3E:
+			case 0x64:
+			case 0x65:
+				a_flags |= Instruction::kSegment;
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		// opcode flags of vex/evex/xop encoded instructions, they always have a ModRM except vzeroupper/vzeroall
+		[[nodiscard]] inline constexpr std::uint8_t vex_flags(std::uint8_t a_map, std::uint8_t a_opcode, bool a_evex) noexcept
+		{
+			switch (a_map) {
+			case 0x1:
+				return !a_evex && a_opcode == 0x77 ? N : M | (OPCODE_MAP_0F[a_opcode] & kImm8);
+			case 0x2:
+			case 0x5:
+			case 0x6:
+				return M;
+			case 0x3:
+			case 0x8:
+				return MB;
+			case 0x9:
+				return M;
+			case 0xA:
+				return MZ;
+			default:
+				return X;
+			}
+		}
+
+		[[nodiscard]] inline constexpr std::uint64_t read_le(const std::uint8_t* a_code, std::size_t a_size) noexcept
+		{
+			std::uint64_t value = 0;
+			for (std::size_t i = 0; i < a_size; ++i) {
+				value |= static_cast<std::uint64_t>(a_code[i]) << (i * 8);
+			}
+
+			return value;
+		}
+
+		[[nodiscard]] inline constexpr std::int64_t sign_extend(std::uint64_t a_value, std::size_t a_size) noexcept
+		{
+			const auto shift = 64 - a_size * 8;
+			return a_size ? static_cast<std::int64_t>(a_value << shift) >> shift : 0;
+		}
+	}  // namespace detail
+
+	/** \brief Decode the length and operand layout of one x86-64 instruction.
+	 * \brief Legacy, REX, VEX, EVEX and XOP encodings are supported, 16-bit addressing is not (64-bit mode).
+	 * \param a_code : bytes of the instruction, starting at its first prefix.
+	 * \param a_size : readable bytes at a_code, capped at MAX_LENGTH.
+	 * \return Instruction : decoded instruction, length is 0 if invalid or truncated.
+	 */
+	[[nodiscard]] inline constexpr Instruction decode(const std::uint8_t* a_code, std::size_t a_size = MAX_LENGTH) noexcept
+	{
+		using namespace detail;
+
+		Instruction inst{};
+		std::size_t i = 0;
+
+		const auto limit = std::min(a_size, MAX_LENGTH);
+		const auto more = [&](std::size_t a_count = 1) noexcept { return i + a_count <= limit; };
+
+		// rex only takes effect right before the opcode
+		for (; more(); ++i) {
+			if ((a_code[i] & 0xF0) == 0x40) {
+				inst.rex = a_code[i];
+			} else if (is_legacy_prefix(a_code[i], inst.flags)) {
+				inst.rex = 0;
+			} else {
+				break;
+			}
+		}
+
+		if (inst.rex) {
+			inst.flags |= Instruction::kRex;
+		}
+
+		if (!more()) {
+			return {};
+		}
+
+		std::uint8_t flags = X;
+		const auto   lead = a_code[i];
+		const bool   xop = lead == 0x8F && more(2) && (a_code[i + 1] & 0x1F) >= 0x8;
+
+		if (lead == 0xC4 || lead == 0xC5 || lead == 0x62 || xop) {
+			const std::size_t payload = lead == 0xC5 ? 1 : lead == 0x62 ? 3 : 2;
+			if (!more(payload + 2)) {
+				return {};
+			}
+
+			if (lead == 0xC5) {
+				inst.map = 0x1;
+				inst.flags |= Instruction::kVex;
+			} else if (lead == 0x62) {
+				inst.map = a_code[i + 1] & 0x07;
+				inst.flags |= Instruction::kEvex;
+			} else {
+				inst.map = a_code[i + 1] & 0x1F;
+				inst.flags |= xop ? Instruction::kXop : Instruction::kVex;
+			}
+
+			i += 1 + payload;
+			inst.opcode = a_code[i];
+			inst.opcodeOffset = static_cast<std::uint8_t>(i++);
+			flags = vex_flags(inst.map, inst.opcode, lead == 0x62);
+		} else if (lead == 0x0F) {
+			if (!more(2)) {
+				return {};
+			}
+
+			const auto escape = a_code[++i];
+			if (escape == 0x38 || escape == 0x3A) {
+				if (!more(2)) {
+					return {};
+				}
+
+				inst.map = escape == 0x38 ? 0x2 : 0x3;
+				flags = escape == 0x38 ? M : MB;
+				++i;
+			} else {
+				inst.map = 0x1;
+				flags = OPCODE_MAP_0F[escape];
+			}
+
+			inst.opcode = a_code[i];
+			inst.opcodeOffset = static_cast<std::uint8_t>(i++);
+		} else {
+			inst.opcode = lead;
+			inst.opcodeOffset = static_cast<std::uint8_t>(i++);
+			flags = OPCODE_MAP_1[lead];
+		}
+
+		if (flags & kInvalid) {
+			return {};
+		}
+
+		if (flags & kModRM) {
+			if (!more()) {
+				return {};
+			}
+
+			inst.modrm = a_code[i];
+			inst.modrmOffset = static_cast<std::uint8_t>(i++);
+
+			// mov to/from control and debug registers always take register operands
+			const auto mod = inst.map == 0x1 && inst.opcode >= 0x20 && inst.opcode <= 0x23 ? 0x3 : inst.modrm >> 6;
+			const auto rm = inst.modrm & 0x7;
+			if (mod != 0x3) {
+				if (rm == 0x4) {
+					if (!more()) {
+						return {};
+					}
+
+					// sib with no base
+					if (mod == 0x0 && (a_code[i] & 0x7) == 0x5) {
+						inst.dispSize = sizeof(std::int32_t);
+					}
+					++i;
+				} else if (mod == 0x0 && rm == 0x5) {
+					inst.dispSize = sizeof(std::int32_t);
+					inst.flags |= Instruction::kRipRelative;
+				}
+
+				if (mod == 0x1) {
+					inst.dispSize = sizeof(std::int8_t);
+				} else if (mod == 0x2) {
+					inst.dispSize = sizeof(std::int32_t);
+				}
+			}
+
+			// test r/m, imm is the only form of group 3 with an immediate
+			if (inst.map == 0x0 && (inst.opcode == 0xF6 || inst.opcode == 0xF7) && ((inst.modrm >> 3) & 0x7) < 0x2) {
+				flags |= inst.opcode == 0xF6 ? kImm8 : kImmZ;
+			}
+		}
+
+		if (inst.dispSize) {
+			if (!more(inst.dispSize)) {
+				return {};
+			}
+
+			inst.disp = static_cast<std::int32_t>(sign_extend(read_le(a_code + i, inst.dispSize), inst.dispSize));
+			inst.dispOffset = static_cast<std::uint8_t>(i);
+			i += inst.dispSize;
+		}
+
+		const bool opSize = (inst.flags & Instruction::kOpSize) && !inst.rex_w();
+
+		std::size_t immSize = 0;
+		if (flags & kImm8) {
+			immSize += sizeof(std::uint8_t);
+		}
+		if (flags & kImm16) {
+			immSize += sizeof(std::uint16_t);
+		}
+		if (flags & kImmZ) {
+			// rel32 ignores operand size override in 64-bit mode
+			immSize += opSize && !(flags & kRel) && !(inst.flags & (Instruction::kVex | Instruction::kXop)) ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+		}
+		if (flags & kImmV) {
+			immSize += inst.rex_w() ? sizeof(std::uint64_t) : opSize ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+		}
+		if (flags & kMoffs) {
+			immSize += inst.flags & Instruction::kAddrSize ? sizeof(std::uint32_t) : sizeof(std::uint64_t);
+		}
+
+		if (immSize) {
+			if (!more(immSize)) {
+				return {};
+			}
+
+			const auto value = read_le(a_code + i, immSize);
+			inst.imm = flags & kRel ? sign_extend(value, immSize) : static_cast<std::int64_t>(value);
+			inst.immOffset = static_cast<std::uint8_t>(i);
+			inst.immSize = static_cast<std::uint8_t>(immSize);
+			i += immSize;
+		}
+
+		if (flags & kRel) {
+			inst.flags |= Instruction::kRelative;
+		}
+
+		inst.length = static_cast<std::uint8_t>(i);
+		return inst;
+	}
+
+	[[nodiscard]] inline Instruction decode(const void* a_code, std::size_t a_size = MAX_LENGTH) noexcept
+	{
+		return decode(static_cast<const std::uint8_t*>(a_code), a_size);
+	}
+
+	/** \brief Rip relative operand or relative branch of one instruction
+	 * \brief For indirect call/jmp [rip + disp32], target is the address of the pointer slot
+	 */
+	struct Displacement
+	{
+		enum class Kind : std::uint8_t
+		{
+			kNone,
+			kCall,    // call rel32, call [rip + disp32]
+			kJump,    // jmp rel8/rel32, jmp [rip + disp32]
+			kBranch,  // jcc, loop, jrcxz
+			kMemory,  // any other [rip + disp32] operand
+		};
+
+		[[nodiscard]] constexpr explicit operator bool() const noexcept { return kind != Kind::kNone; }
+
+		std::uintptr_t target{ 0 };
+		std::uint8_t   offset{ 0 };  // of the displacement within instruction
+		std::uint8_t   size{ 0 };    // of the displacement
+		std::uint8_t   length{ 0 };  // of the instruction
+		Kind           kind{ Kind::kNone };
+		bool           indirect{ false };
+	};
+
+	/** \brief Resolve the rip relative operand or relative branch of one instruction.
+	 * \param a_code : bytes of the instruction, starting at its first prefix.
+	 * \param a_address : address the instruction is located at.
+	 * \param a_size : readable bytes at a_code.
+	 * \return Displacement : kind is kNone if the instruction has neither or fails to decode.
+	 */
+	[[nodiscard]] inline constexpr Displacement displacement(const std::uint8_t* a_code, std::uintptr_t a_address, std::size_t a_size = MAX_LENGTH) noexcept
+	{
+		using Kind = Displacement::Kind;
+
+		const auto inst = decode(a_code, a_size);
+
+		Displacement disp{};
+		disp.length = inst.length;
+
+		if (inst.relative()) {
+			disp.target = inst.target(a_address);
+			disp.offset = inst.immOffset;
+			disp.size = inst.immSize;
+
+			if (inst.map == 0x0 && inst.opcode == 0xE8) {
+				disp.kind = Kind::kCall;
+			} else if (inst.map == 0x0 && (inst.opcode == 0xE9 || inst.opcode == 0xEB)) {
+				disp.kind = Kind::kJump;
+			} else {
+				disp.kind = Kind::kBranch;
+			}
+		} else if (inst.rip_relative()) {
+			disp.target = inst.target(a_address);
+			disp.offset = inst.dispOffset;
+			disp.size = inst.dispSize;
+			disp.kind = Kind::kMemory;
+
+			// FF /2 call, FF /4 jmp, far forms /3 /5 read a m16:64 and stay memory operands
+			if (inst.map == 0x0 && inst.opcode == 0xFF) {
+				switch ((inst.modrm >> 3) & 0x7) {
+				case 0x2:
+					disp.kind = Kind::kCall;
+					disp.indirect = true;
+					break;
+				case 0x4:
+					disp.kind = Kind::kJump;
+					disp.indirect = true;
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		return disp;
+	}
+
+	/** \brief Smallest instruction aligned length that covers at least a_minBytes.
+	 * \param a_code : first instruction.
+	 * \param a_minBytes : minimum bytes to cover.
+	 * \param a_size : readable bytes at a_code.
+	 * \return std::size_t : sum of whole instruction lengths, 0 if any instruction fails to decode.
+	 */
+	[[nodiscard]] inline constexpr std::size_t boundary(const std::uint8_t* a_code, std::size_t a_minBytes, std::size_t a_size = SIZE_MAX) noexcept
+	{
+		std::size_t length = 0;
+		while (length < a_minBytes) {
+			if (a_size <= length) {
+				return 0;
+			}
+
+			const auto inst = decode(a_code + length, a_size - length);
+			if (!inst.valid()) {
+				return 0;
+			}
+
+			length += inst.length;
+		}
+
+		return length;
+	}
+
+	namespace detail
+	{
+		struct Relocation
+		{
+			Instruction    inst;
+			std::size_t    offset;
+			std::size_t    newOffset;
+			std::uintptr_t target;
+			bool           internal;
+			bool           absolute;
+		};
+
+		[[nodiscard]] inline constexpr bool in_rel32(std::int64_t a_disp) noexcept
+		{
+			return a_disp >= INT32_MIN && a_disp <= INT32_MAX;
+		}
+
+		[[nodiscard]] inline constexpr bool is_call(const Instruction& a_inst) noexcept
+		{
+			return a_inst.map == 0x0 && a_inst.opcode == 0xE8;
+		}
+
+		[[nodiscard]] inline constexpr bool is_jcc(const Instruction& a_inst) noexcept
+		{
+			return (a_inst.map == 0x0 && (a_inst.opcode & 0xF0) == 0x70) ||
+			       (a_inst.map == 0x1 && (a_inst.opcode & 0xF0) == 0x80);
+		}
+
+		// loopne, loope, loop, jrcxz only have a rel8 form
+		[[nodiscard]] inline constexpr bool is_loop(const Instruction& a_inst) noexcept
+		{
+			return a_inst.map == 0x0 && a_inst.opcode >= 0xE0 && a_inst.opcode <= 0xE3;
+		}
+
+		// 0x67 selects ecx as counter of loop and jecxz, it must be kept
+		[[nodiscard]] inline constexpr std::size_t loop_prefix(const Instruction& a_inst) noexcept
+		{
+			return is_loop(a_inst) && (a_inst.flags & Instruction::kAddrSize) ? 1 : 0;
+		}
+
+		// jmp [rip + 0] ; dq target
+		inline constexpr std::size_t JMP_ABS_SIZE = 6 + sizeof(std::uint64_t);
+		inline constexpr std::size_t JMP_REL_SIZE = 1 + sizeof(std::int32_t);
+
+		[[nodiscard]] inline constexpr std::size_t branch_size(const Instruction& a_inst, bool a_absolute) noexcept
+		{
+			if (is_loop(a_inst)) {
+				// [67] loop +2 ; jmp +N ; jmp target
+				return loop_prefix(a_inst) + 4 + (a_absolute ? JMP_ABS_SIZE : JMP_REL_SIZE);
+			} else if (is_jcc(a_inst)) {
+				// jncc +N ; jmp target
+				return a_absolute ? 2 + JMP_ABS_SIZE : 2 + sizeof(std::int32_t);
+			} else if (is_call(a_inst)) {
+				// call [rip + 2] ; jmp +8 ; dq target
+				return a_absolute ? 8 + sizeof(std::uint64_t) : JMP_REL_SIZE;
+			} else {
+				return a_absolute ? JMP_ABS_SIZE : JMP_REL_SIZE;
+			}
+		}
+
+		inline void emit(std::vector<std::uint8_t>& a_out, std::uint64_t a_value, std::size_t a_size)
+		{
+			for (std::size_t i = 0; i < a_size; ++i) {
+				a_out.push_back(static_cast<std::uint8_t>(a_value >> (i * 8)));
+			}
+		}
+
+		inline void emit_jmp(std::vector<std::uint8_t>& a_out, std::uintptr_t a_at, std::uintptr_t a_target, bool a_absolute)
+		{
+			if (a_absolute) {
+				a_out.insert(a_out.end(), { 0xFF, 0x25, 0x00, 0x00, 0x00, 0x00 });
+				emit(a_out, a_target, sizeof(std::uint64_t));
+			} else {
+				a_out.push_back(0xE9);
+				emit(a_out, a_target - a_at - JMP_REL_SIZE, sizeof(std::int32_t));
+			}
+		}
+
+		// re-encode a relative branch at a_at
+		inline void emit_branch(std::vector<std::uint8_t>& a_out, const Instruction& a_inst, std::uintptr_t a_at, std::uintptr_t a_target, bool a_absolute)
+		{
+			const auto jmpSize = a_absolute ? JMP_ABS_SIZE : JMP_REL_SIZE;
+
+			if (is_loop(a_inst)) {
+				const auto prefix = loop_prefix(a_inst);
+				if (prefix) {
+					a_out.push_back(0x67);
+				}
+				a_out.insert(a_out.end(), { a_inst.opcode, 0x02, 0xEB, static_cast<std::uint8_t>(jmpSize) });
+				emit_jmp(a_out, a_at + prefix + 4, a_target, a_absolute);
+			} else if (is_jcc(a_inst)) {
+				const std::uint8_t cc = a_inst.opcode & 0x0F;
+				if (a_absolute) {
+					a_out.insert(a_out.end(), { static_cast<std::uint8_t>(0x70 | (cc ^ 0x1)), static_cast<std::uint8_t>(jmpSize) });
+					emit_jmp(a_out, a_at + 2, a_target, true);
+				} else {
+					a_out.insert(a_out.end(), { 0x0F, static_cast<std::uint8_t>(0x80 | cc) });
+					emit(a_out, a_target - a_at - 2 - sizeof(std::int32_t), sizeof(std::int32_t));
+				}
+			} else if (is_call(a_inst)) {
+				if (a_absolute) {
+					a_out.insert(a_out.end(), { 0xFF, 0x15, 0x02, 0x00, 0x00, 0x00, 0xEB, 0x08 });
+					emit(a_out, a_target, sizeof(std::uint64_t));
+				} else {
+					a_out.push_back(0xE8);
+					emit(a_out, a_target - a_at - JMP_REL_SIZE, sizeof(std::int32_t));
+				}
+			} else {
+				emit_jmp(a_out, a_at, a_target, a_absolute);
+			}
+		}
+	}  // namespace detail
+
+	/** \brief Upper bound of the relocated size of an instruction sequence, relative branches at their largest form.
+	 * \param a_code : instructions to relocate.
+	 * \param a_size : size of a_code, must end on an instruction boundary.
+	 * \return std::size_t : largest size relocate can produce, 0 if any instruction cannot be decoded.
+	 */
+	[[nodiscard]] inline constexpr std::size_t relocate_bound(const std::uint8_t* a_code, std::size_t a_size) noexcept
+	{
+		std::size_t bound = 0;
+		for (std::size_t offset = 0; offset < a_size;) {
+			const auto inst = decode(a_code + offset, a_size - offset);
+			if (!inst.valid()) {
+				return 0;
+			}
+
+			bound += inst.relative() ? (std::max)(static_cast<std::size_t>(inst.length), detail::branch_size(inst, true)) : inst.length;
+			offset += inst.length;
+		}
+
+		return bound;
+	}
+
+	/** \brief Relocate whole instructions to execute at a new address.
+	 * \brief Rip relative operands are re-targeted, short branches are widened to rel32 and branches that cannot
+	 * \brief reach their target with rel32 become absolute indirect jumps. Branches into the block itself are
+	 * \brief redirected into the relocated copy.
+	 * \param a_code : instructions to relocate.
+	 * \param a_size : size of a_code, must end on an instruction boundary.
+	 * \param a_from : address a_code was executing at.
+	 * \param a_to : address the relocated code will execute at.
+	 * \return std::vector<std::uint8_t> : relocated code, empty if any instruction cannot be decoded or relocated.
+	 */
+	[[nodiscard]] inline std::vector<std::uint8_t> relocate(const std::uint8_t* a_code, std::size_t a_size, std::uintptr_t a_from, std::uintptr_t a_to)
+	{
+		using namespace detail;
+
+		// upper bound of relocated size, every instruction at its largest form
+		const auto bound = a_to + relocate_bound(a_code, a_size);
+
+		std::vector<Relocation> insts;
+		for (std::size_t offset = 0; offset < a_size;) {
+			const auto inst = decode(a_code + offset, a_size - offset);
+			if (!inst.valid()) {
+				return {};
+			}
+
+			insts.push_back({ inst, offset, 0, inst.target(a_from + offset), false, false });
+			offset += inst.length;
+		}
+
+		std::size_t newOffset = 0;
+		for (auto& reloc : insts) {
+			reloc.newOffset = newOffset;
+
+			if (reloc.inst.relative()) {
+				reloc.internal = reloc.target >= a_from && reloc.target < a_from + a_size;
+				reloc.absolute = !reloc.internal &&
+				                 (!in_rel32(static_cast<std::int64_t>(reloc.target - a_to)) || !in_rel32(static_cast<std::int64_t>(reloc.target - bound)));
+				newOffset += branch_size(reloc.inst, reloc.absolute);
+			} else {
+				newOffset += reloc.inst.length;
+			}
+		}
+
+		std::vector<std::uint8_t> code;
+		code.reserve(newOffset);
+
+		for (auto& reloc : insts) {
+			const auto at = a_to + reloc.newOffset;
+
+			if (reloc.inst.relative()) {
+				auto target = reloc.target;
+				if (reloc.internal) {
+					auto it = std::ranges::find(insts, target - a_from, &Relocation::offset);
+					if (it == insts.end()) {
+						return {};
+					}
+
+					target = a_to + it->newOffset;
+				}
+
+				emit_branch(code, reloc.inst, at, target, reloc.absolute);
+			} else {
+				code.insert(code.end(), a_code + reloc.offset, a_code + reloc.offset + reloc.inst.length);
+
+				if (reloc.inst.rip_relative()) {
+					const auto disp = static_cast<std::int64_t>(reloc.target - at - reloc.inst.length);
+					if (!in_rel32(disp)) {
+						return {};
+					}
+
+					for (std::size_t i = 0; i < sizeof(std::int32_t); ++i) {
+						code[reloc.newOffset + reloc.inst.dispOffset + i] = static_cast<std::uint8_t>(disp >> (i * 8));
+					}
+				}
+			}
+		}
+
+		return code;
+	}
+}  // namespace DKUtil::Hook::Disasm
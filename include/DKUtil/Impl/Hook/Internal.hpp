@@ -1,8 +1,8 @@
 #pragma once
 
-#include "assembly.hpp"
-#include "jit.hpp"
-#include "trampoline.hpp"
+#include "Assembly.hpp"
+#include "JIT.hpp"
+#include "Trampoline.hpp"
 
 namespace DKUtil::Hook
 {
@@ -11,7 +11,14 @@ namespace DKUtil::Hook
 	class HookHandle
 	{
 	public:
-		virtual ~HookHandle() = default;
+		virtual ~HookHandle()
+		{
+			// an enabled hook may still branch into its trampoline block, a block that calls the hook function
+			// may still be returned to by a thread inside it
+			if (!Enabled && !KeepBlock) {
+				Release();
+			}
+		}
 
 		virtual void Enable() noexcept = 0;
 		virtual void Disable() noexcept = 0;
@@ -22,24 +29,47 @@ namespace DKUtil::Hook
 			return dynamic_cast<derived_t*>(this);
 		}
 
+		/** \brief Return the trampoline block of a disabled hook now.
+		 * \brief Blocks that call the hook function are kept on destruction, caller guarantees no thread is still inside the hook.
+		 */
+		void Release() noexcept
+		{
+			dku_assert(!Enabled, "DKU_H: Cannot release trampoline block of enabled hook @ {:X}", Address);
+			if (TramSize) {
+				TRAM_FREE(TramBlock, TramSize);
+				TramSize = 0;
+			}
+		}
+
 		// write directly to internal trampoline ptr
 		template <typename T>
 			requires(!std::is_pointer_v<T>)
 		void Write(T a_in) noexcept
 		{
-			WriteData(TramPtr, std::addressof(a_in), sizeof(a_in), true);
-			TramPtr += sizeof(a_in);
+			Write(std::addressof(a_in), sizeof(a_in));
 		}
 
+		// writes within the reserved trampoline block, the trampoline may hand out any address so none is assumed
 		void Write(const void* a_src, std::size_t a_size) noexcept
 		{
-			WriteData(TramPtr, a_src, a_size, true);
+			dku_assert(TramSize && TramPtr >= TramBlock && TramPtr + a_size <= TramBlock + TramSize,
+				"DKU_H: Trampoline write is outside the block reserved by hook\n"
+				"block : {:X}\nsize  : {}\nwrite : {:X} + {}",
+				TramBlock, TramSize, TramPtr, a_size);
+			std::memcpy(AsPointer(TramPtr), a_src, a_size);
+
 			TramPtr += a_size;
 		}
 
 		const std::uintptr_t Address;
 		const std::uintptr_t TramEntry;
 		std::uintptr_t       TramPtr{ 0x0 };
+		// trampoline block owned by this hook, returned to trampoline on destruction if disabled and not kept
+		std::uintptr_t       TramBlock{ 0x0 };
+		std::size_t          TramSize{ 0 };
+		bool                 Enabled{ false };
+		// block holds a call the hook function returns through, only Release returns it
+		bool                 KeepBlock{ false };
 
 	protected:
 		HookHandle(const std::uintptr_t a_address, const std::uintptr_t a_tramEntry) :
@@ -50,10 +80,15 @@ namespace DKUtil::Hook
 
 #define DKU_H_INTERNAL_IMPORTS DKU_H_VERSION_MAJOR
 
+#include "Internal/HookStats.hpp"
+#include "Internal/HookChain.hpp"
+
 #include "Internal/ASMPatch.hpp"
 #include "Internal/CaveHook.hpp"
 #include "Internal/IATHook.hpp"
 #include "Internal/RelHook.hpp"
 #include "Internal/VMTHook.hpp"
 
+#include "Internal/CallerProfiler.hpp"
+
 #undef DKU_H_INTERNAL_IMPORTS
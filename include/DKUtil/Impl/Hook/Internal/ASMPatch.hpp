@@ -27,12 +27,14 @@ namespace DKUtil::Hook
 		void Enable() noexcept override
 		{
 			WriteData(TramEntry, PatchBuf.data(), PatchSize, false);
+			Enabled = true;
 			__DEBUG("DKU_H: Enabled ASM patch @ {:X}", TramEntry);
 		}
 
 		void Disable() noexcept override
 		{
 			WriteData(TramEntry, OldBytes.data(), PatchSize, false);
+			Enabled = false;
 			__DEBUG("DKU_H: Disabled ASM patch @ {:X}", TramEntry);
 		}
 
@@ -68,7 +70,9 @@ namespace DKUtil::Hook
 			JmpRel asmDetour;  // cave -> tram
 			JmpRel asmReturn;  // tram -> cave
 
-			handle->TramPtr = TRAM_ALLOC(0);
+			handle->TramSize = a_patch.second + sizeof(asmReturn);
+			handle->TramBlock = TRAM_ALLOC_NEAR(handle->TramSize, handle->TramEntry);
+			handle->TramPtr = handle->TramBlock;
 			__DEBUG("DKU_H: ASM patch trampoline entry -> {:X}", handle->TramPtr);
 
 			std::ptrdiff_t disp = handle->TramPtr - handle->TramEntry - sizeof(asmDetour);
@@ -0,0 +1,362 @@
+#pragma once
+
+#if !defined(DKU_H_INTERNAL_IMPORTS)
+#	error Incorrect DKUtil::Hook internal import order.
+#endif
+
+namespace DKUtil::Hook
+{
+	/** \brief Sampling histogram of the callers of a function.
+	 * \brief A sampling thunk runs in front of the function, through a vtable swap or a cave hook at the function entry.
+	 * \brief One in Rate calls records its return address into a lock free ring buffer of the calling thread, the other
+	 * \brief calls only count down. Rings are drained into the caller table when it is read, a ring that wraps before it is
+	 * \brief drained keeps the most recent samples and counts the overwritten ones as dropped.
+	 * \brief The countdown is shared by threads without lock, the rate is approximate when several threads call the function.
+	 */
+	class CallerProfiler
+	{
+	public:
+		static constexpr std::size_t RING_SIZE = 0x400;
+
+		struct Caller
+		{
+			std::uintptr_t Address;     // return address
+			std::uintptr_t RawAddress;  // aslr disabled address, 0 if not in a module
+			std::string    Module;
+			std::uint64_t  Samples;
+		};
+
+		CallerProfiler(const CallerProfiler&) = delete;
+		CallerProfiler& operator=(const CallerProfiler&) = delete;
+
+		// the thunk may still be running, only the caller table is released
+		~CallerProfiler()
+		{
+			auto&            stats = storage();
+			std::unique_lock guard{ stats.lock };
+
+			drain(stats);
+			stats.histograms.erase(_id);
+		}
+
+		/** \brief Sample the callers of a virtual function by swapping its vtable entry
+		 * \param a_vtbl : Pointer to virtual method table (base address of class object)
+		 * \param a_index : Index of the virtual function in the virtual method table
+		 * \param a_rate : Record one in a_rate calls
+		 * \return std::unique_ptr<CallerProfiler> : profiler, disabled
+		 */
+		[[nodiscard]] static std::unique_ptr<CallerProfiler> AttachVMT(
+			const void*         a_vtbl,
+			const std::uint16_t a_index,
+			const std::uint32_t a_rate = 64) noexcept
+		{
+			const auto original = *std::bit_cast<const std::uintptr_t*>(TblToAbs(*std::bit_cast<const std::uintptr_t*>(a_vtbl), a_index));
+
+			auto       profiler = create(a_rate);
+			const auto thunk = profiler->make_thunk(original, 0);
+			profiler->Handle = AddVMTHook(a_vtbl, a_index, FuncInfo{ thunk, 0, "CallerProfiler" });
+
+			return profiler;
+		}
+
+		/** \brief Sample the callers of a function through a cave hook at its entry
+		 * \param a_function : Memory address of the BEGINNING of target function
+		 * \param a_rate : Record one in a_rate calls
+		 * \return std::unique_ptr<CallerProfiler> : profiler, disabled
+		 */
+		[[nodiscard]] static std::unique_ptr<CallerProfiler> AttachCave(
+			const std::uintptr_t a_function,
+			const std::uint32_t  a_rate = 64) noexcept
+		{
+			const auto size = Disasm::boundary(std::bit_cast<const OpCode*>(a_function), sizeof(JmpRel));
+			dku_assert(size,
+				"DKU_H: CallerProfiler failed to decode entry of function {:X}", a_function);
+
+			// cave trampoline allocates stack and calls the thunk, return address of function is above both
+			auto       profiler = create(a_rate);
+			const auto thunk = profiler->make_thunk(0, sizeof(Imm64) + ASM_STACK_ALLOC_SIZE);
+			profiler->Handle = AddCaveHook(
+				a_function, { 0, static_cast<std::ptrdiff_t>(size) }, FuncInfo{ thunk, 0, "CallerProfiler" },
+				std::make_pair(nullptr, 0), std::make_pair(nullptr, 0),
+				{ HookFlag::kRestoreAfterEpilog, HookFlag::kSkipNOP });
+
+			return profiler;
+		}
+
+		void Enable() noexcept { Handle->Enable(); }
+		void Disable() noexcept { Handle->Disable(); }
+
+		/** \brief Callers with the most samples, symbolized when read
+		 * \param a_count : Number of callers
+		 * \return std::vector<Caller> : callers in descending order of samples
+		 */
+		[[nodiscard]] std::vector<Caller> Top(const std::size_t a_count = 10) const noexcept
+		{
+			std::vector<std::pair<std::uintptr_t, std::uint64_t>> callers;
+			{
+				auto&            stats = storage();
+				std::unique_lock guard{ stats.lock };
+
+				drain(stats);
+				const auto& histogram = stats.histograms[_id];
+				callers.assign(histogram.begin(), histogram.end());
+			}
+
+			const auto count = (std::min)(a_count, callers.size());
+			std::ranges::partial_sort(callers, callers.begin() + count, std::ranges::greater{}, &std::pair<std::uintptr_t, std::uint64_t>::second);
+			callers.resize(count);
+
+			std::vector<Caller> top;
+			for (const auto& [address, samples] : callers) {
+				const auto* module = ModuleFor(address);
+				top.emplace_back(address, module ? GetRawAddress(address) : 0, module ? module->name() : std::string{}, samples);
+			}
+
+			return top;
+		}
+
+		// total samples recorded for this profiler
+		[[nodiscard]] std::uint64_t Samples() const noexcept
+		{
+			auto&            stats = storage();
+			std::unique_lock guard{ stats.lock };
+
+			drain(stats);
+			std::uint64_t samples = 0;
+			for (const auto& [address, count] : stats.histograms[_id]) {
+				samples += count;
+			}
+
+			return samples;
+		}
+
+		void Reset() noexcept
+		{
+			auto&            stats = storage();
+			std::unique_lock guard{ stats.lock };
+
+			drain(stats);
+			stats.histograms[_id].clear();
+		}
+
+		// samples overwritten before they were drained, of all profilers
+		[[nodiscard]] static std::uint64_t Dropped() noexcept
+		{
+			auto&            stats = storage();
+			std::unique_lock guard{ stats.lock };
+
+			drain(stats);
+			return stats.dropped;
+		}
+
+		std::unique_ptr<HookHandle> Handle;
+
+	private:
+		// id is packed above the 48 bit user space address
+		static constexpr std::size_t   ID_SHIFT = 48;
+		static constexpr std::uint64_t ADDRESS_MASK = (static_cast<std::uint64_t>(1) << ID_SHIFT) - 1;
+
+		struct alignas(HookStats::CACHE_LINE) Countdown
+		{
+			std::uint32_t Value;
+		};
+
+		// single producer is the owning thread, single consumer is drain under storage lock
+		struct Ring
+		{
+			void push(const std::uint64_t a_sample) noexcept
+			{
+				const auto index = head.load(std::memory_order_relaxed);
+				samples[index % RING_SIZE].store(a_sample, std::memory_order_release);
+				head.store(index + 1, std::memory_order_release);
+			}
+
+			alignas(HookStats::CACHE_LINE) std::atomic<std::uint64_t> head{ 0 };
+			alignas(HookStats::CACHE_LINE) std::uint64_t              tail{ 0 };
+			std::array<std::atomic<std::uint64_t>, RING_SIZE>          samples{};
+		};
+
+		struct Storage
+		{
+			std::mutex                                                                           lock;
+			std::vector<std::shared_ptr<Ring>>                                                   rings;
+			std::unordered_map<std::uint16_t, std::unordered_map<std::uintptr_t, std::uint64_t>> histograms;
+			std::deque<Countdown>                                                                countdowns;
+			std::uint16_t                                                                        lastId{ 0 };
+			std::uint64_t                                                                        dropped{ 0 };
+		};
+
+		explicit CallerProfiler(const std::uint16_t a_id, Countdown& a_countdown, const std::uint32_t a_rate) noexcept :
+			_id(a_id), _countdown(a_countdown), _rate(a_rate)
+		{}
+
+		[[nodiscard]] static Storage& storage() noexcept
+		{
+			static Storage stats;
+			return stats;
+		}
+
+		[[nodiscard]] static std::unique_ptr<CallerProfiler> create(const std::uint32_t a_rate) noexcept
+		{
+			dku_assert(a_rate && a_rate <= static_cast<std::uint32_t>((std::numeric_limits<std::int32_t>::max)()),
+				"DKU_H: CallerProfiler sample rate must be within 1 and INT32_MAX, it is {}", a_rate);
+
+			auto&            stats = storage();
+			std::unique_lock guard{ stats.lock };
+
+			dku_assert(stats.lastId < (std::numeric_limits<std::uint16_t>::max)(),
+				"DKU_H: CallerProfiler ids exhausted");
+
+			// countdowns are never freed, a disabled hook may still be running its thunk
+			auto& countdown = stats.countdowns.emplace_back(a_rate);
+			stats.histograms[++stats.lastId];
+
+			return std::unique_ptr<CallerProfiler>(new CallerProfiler(stats.lastId, countdown, a_rate));
+		}
+
+		// called by the thunk on sampled calls
+		static void record(const std::uint64_t a_id, const std::uintptr_t a_caller) noexcept
+		{
+			thread_local const auto ring = [] {
+				auto&            stats = storage();
+				std::unique_lock guard{ stats.lock };
+				return stats.rings.emplace_back(std::make_shared<Ring>());
+			}();
+
+			ring->push(a_id << ID_SHIFT | (a_caller & ADDRESS_MASK));
+		}
+
+		static void drain(Storage& a_stats) noexcept
+		{
+			std::vector<std::uint64_t> samples(RING_SIZE);
+			for (auto& ring : a_stats.rings) {
+				const auto head = ring->head.load(std::memory_order_acquire);
+				const auto first = (std::max)(ring->tail, head > RING_SIZE ? head - RING_SIZE : 0);
+				for (auto i = first; i < head; ++i) {
+					samples[i - first] = ring->samples[i % RING_SIZE].load(std::memory_order_acquire);
+				}
+
+				// slots overwritten while reading, including the one being written now, are discarded
+				const auto now = ring->head.load(std::memory_order_acquire);
+				const auto valid = (std::max)(first, now >= RING_SIZE ? now - RING_SIZE + 1 : 0);
+				a_stats.dropped += (std::min)(valid, head) - ring->tail;
+
+				for (auto i = valid; i < head; ++i) {
+					const auto sample = samples[i - first];
+					if (auto it = a_stats.histograms.find(static_cast<std::uint16_t>(sample >> ID_SHIFT)); it != a_stats.histograms.end()) {
+						++it->second[sample & ADDRESS_MASK];
+					}
+				}
+
+				ring->tail = head;
+			}
+
+			// rings of exited threads are released once drained
+			std::erase_if(a_stats.rings, [](const auto& a_ring) { return a_ring.use_count() == 1; });
+		}
+
+		// [imm64 original] countdown | sampled: reset countdown, save arguments, record(id, [rsp + depth]), restore | jmp original or ret
+		[[nodiscard]] std::uintptr_t make_thunk(const std::uintptr_t a_original, const std::size_t a_depth) const noexcept
+		{
+#if defined(_WIN32)
+			// rcx rdx r8 r9 rax, xmm0-3, id and caller passed in rcx rdx
+			constexpr std::uint8_t gprs[] = { 1, 2, 8, 9, 0 };
+			constexpr std::size_t  home = 0x20;
+			constexpr std::size_t  xmmArgs = 4;
+			constexpr OpCode       movId[] = { 0x48, 0xB9 };
+			constexpr OpCode       movCaller[] = { 0x48, 0x8B, 0x94, 0x24 };
+#else
+			// rdi rsi rdx rcx r8 r9 rax, xmm0-7, id and caller passed in rdi rsi
+			constexpr std::uint8_t gprs[] = { 7, 6, 2, 1, 8, 9, 0 };
+			constexpr std::size_t  home = 0x0;
+			constexpr std::size_t  xmmArgs = 8;
+			constexpr OpCode       movId[] = { 0x48, 0xBF };
+			constexpr OpCode       movCaller[] = { 0x48, 0x8B, 0xB4, 0x24 };
+#endif
+			// thunk is entered with rsp at 8 mod 16 below the return address, rsp is aligned for the call
+			const auto pushed = std::size(gprs) * sizeof(Imm64);
+			const auto frame = home + xmmArgs * 0x10 + (sizeof(Imm64) + a_depth + pushed + home) % 0x10;
+
+			std::vector<OpCode> code;
+			const auto          emit = [&](std::initializer_list<OpCode> a_bytes) { code.insert(code.end(), a_bytes); };
+			const auto          emitImm = [&](const auto a_imm) {
+				const auto at = code.size();
+				code.resize(at + sizeof(a_imm));
+				std::memcpy(code.data() + at, std::addressof(a_imm), sizeof(a_imm));
+			};
+			const auto          leave = [&]() {
+				if (a_original) {
+					// jmp qword ptr [rip - original]
+					emit({ 0xFF, 0x25 });
+					emitImm(-static_cast<Disp32>(code.size() + sizeof(Disp32)));
+				} else {
+					emit({ 0xC3 });
+				}
+			};
+
+			emitImm(a_original);
+
+			// mov r11, countdown | dec dword ptr [r11] | jle sampled
+			// racing decrements may step below zero, every one of them samples and resets
+			emit({ 0x49, 0xBB });
+			emitImm(AsAddress(std::addressof(_countdown)));
+			emit({ 0x41, 0xFF, 0x0B, 0x7E, static_cast<OpCode>(a_original ? sizeof(JmpRip) : sizeof(OpCode)) });
+			leave();
+
+			// mov dword ptr [r11], rate
+			emit({ 0x41, 0xC7, 0x03 });
+			emitImm(_rate);
+
+			for (const auto gpr : gprs) {
+				if (gpr >= 8) {
+					emit({ 0x41 });
+				}
+				emit({ static_cast<OpCode>(0x50 + (gpr & 7)) });
+			}
+
+			// sub rsp, frame | movdqu [rsp + home + i * 0x10], xmm
+			emit({ 0x48, 0x81, 0xEC });
+			emitImm(static_cast<Imm32>(frame));
+			for (std::uint8_t i = 0; i < xmmArgs; ++i) {
+				emit({ 0xF3, 0x0F, 0x7F, static_cast<OpCode>(0x84 | i << 3), 0x24 });
+				emitImm(static_cast<Disp32>(home + i * 0x10));
+			}
+
+			// mov id, imm64 | mov caller, [rsp + frame + pushed + depth] | mov rax, record | call rax
+			code.insert(code.end(), std::begin(movId), std::end(movId));
+			emitImm(static_cast<Imm64>(_id));
+			code.insert(code.end(), std::begin(movCaller), std::end(movCaller));
+			emitImm(static_cast<Disp32>(frame + pushed + a_depth));
+			emit({ 0x48, 0xB8 });
+			emitImm(AsAddress(&record));
+			emit({ 0xFF, 0xD0 });
+
+			// movdqu xmm, [rsp + home + i * 0x10] | add rsp, frame
+			for (std::uint8_t i = 0; i < xmmArgs; ++i) {
+				emit({ 0xF3, 0x0F, 0x6F, static_cast<OpCode>(0x84 | i << 3), 0x24 });
+				emitImm(static_cast<Disp32>(home + i * 0x10));
+			}
+			emit({ 0x48, 0x81, 0xC4 });
+			emitImm(static_cast<Imm32>(frame));
+
+			for (const auto gpr : gprs | std::views::reverse) {
+				if (gpr >= 8) {
+					emit({ 0x41 });
+				}
+				emit({ static_cast<OpCode>(0x58 + (gpr & 7)) });
+			}
+
+			leave();
+
+			const auto tramBlock = TRAM_ALLOC(code.size());
+			std::memcpy(AsPointer(tramBlock), code.data(), code.size());
+
+			__DEBUG("DKU_H: CallerProfiler {} thunk @ {:X} -> {:X}\n1 in {} calls", _id, tramBlock + sizeof(Imm64), a_original, _rate);
+			return tramBlock + sizeof(Imm64);
+		}
+
+		const std::uint16_t _id;
+		Countdown&          _countdown;
+		const std::uint32_t _rate;
+	};
+}  // namespace DKUtil::Hook
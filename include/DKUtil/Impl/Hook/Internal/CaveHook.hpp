@@ -32,6 +32,7 @@ namespace DKUtil::Hook
 		{
 			WriteData(CavePtr, CaveBuf.data(), CaveSize, false);
 			CavePtr += CaveSize;
+			Enabled = true;
 			__DEBUG("DKU_H: Enabled cave hook @ {:X}", CaveEntry);
 		}
 
@@ -39,9 +40,24 @@ namespace DKUtil::Hook
 		{
 			WriteData(CavePtr - CaveSize, OldBytes.data(), CaveSize, false);
 			CavePtr -= CaveSize;
+			Enabled = false;
 			__DEBUG("DKU_H: Disabled cave hook @ {:X}", CaveEntry);
 		}
 
+		// stolen bytes are relocated against the trampoline address they are written to
+		std::size_t WriteOldBytes() noexcept
+		{
+			const auto relocated = Disasm::relocate(OldBytes.data(), CaveSize, CaveEntry, TramPtr);
+			dku_assert(!relocated.empty(),
+				"DKU_H: Failed to relocate stolen bytes to trampoline\n"
+				"cave entry : {:X}\n"
+				"tram ptr   : {:X}",
+				CaveEntry, TramPtr);
+
+			Write(relocated.data(), relocated.size());
+			return relocated.size();
+		}
+
 		const offset_pair    Offset;
 		const std::size_t    CaveSize;
 		const std::uintptr_t CaveEntry;
@@ -67,6 +83,9 @@ namespace DKUtil::Hook
 		const unpacked_data          a_epilog = std::make_pair(nullptr, 0),
 		model::enumeration<HookFlag> a_flag = HookFlag::kSkipNOP) noexcept
 	{
+		dku_assert(!HookChain::Owns(a_address + a_offset.first, a_offset.second - a_offset.first),
+			"DKU_H: Cave {:X} overlaps a site owned by a HookChain", a_address + a_offset.first);
+
 		if (a_offset.second - a_offset.first == 5) {
 			a_flag.reset(HookFlag::kSkipNOP);
 		}
@@ -79,6 +98,7 @@ namespace DKUtil::Hook
 
 		// trampoline layout
 		// [qword imm64] <- tram entry after this
+		// stolen bytes are relocated, rip relative operands and branches still reach their targets
 		// [stolen] <- kRestoreBeforeProlog
 		// [prolog] <- cave detour entry
 		// [stolen] <- kRestoreAfterProlog
@@ -89,11 +109,22 @@ namespace DKUtil::Hook
 		// [epilog]
 		// [stolen] <- kRestoreAfterEpilog
 		// [jmp rel32]
-		auto tramPtr = TRAM_ALLOC(0);
-
-		// tram entry
-		WriteImm(tramPtr, a_funcInfo.address(), true);
-		tramPtr += sizeof(a_funcInfo.address());
+		// stolen bytes are reserved at their largest relocated form
+		const auto stolenSize = Disasm::relocate_bound(std::bit_cast<const OpCode*>(a_address + a_offset.first), a_offset.second - a_offset.first);
+		const auto restores = static_cast<std::size_t>(std::ranges::count_if(
+			std::array{ HookFlag::kRestoreBeforeProlog, HookFlag::kRestoreAfterProlog, HookFlag::kRestoreBeforeEpilog, HookFlag::kRestoreAfterEpilog },
+			[&](auto a_restore) { return a_flag.any(a_restore); }));
+		const auto tramSize = sizeof(Imm64) + stolenSize * restores + a_prolog.second + a_epilog.second +
+		                      sizeof(asmSub) + sizeof(asmBranch) + sizeof(asmAdd) + sizeof(asmReturn);
+		const auto tramBlock = TRAM_ALLOC_NEAR(tramSize, a_address + a_offset.first);
+		auto       tramPtr = tramBlock;
+
+		// tram entry, profiled hook function is called through its counting thunk
+		const auto callee = a_flag.any(HookFlag::kProfile) ?
+		                    HookStats::MakeThunk(a_funcInfo.address(), a_address + a_offset.first, a_funcInfo.name()) :
+		                    a_funcInfo.address();
+		AsMemCpy(tramPtr, callee);
+		tramPtr += sizeof(callee);
 		__DEBUG(
 			"DKU_H: Detouring...\n"
 			"from : {}.{:X}\n"
@@ -101,6 +132,9 @@ namespace DKUtil::Hook
 			GetModuleName(), a_address + a_offset.first, a_funcInfo.name(), PROJECT_NAME, a_funcInfo.address());
 
 		auto handle = std::make_unique<CaveHookHandle>(a_address, tramPtr, a_offset);
+		handle->TramBlock = tramBlock;
+		handle->TramSize = tramSize;
+		handle->KeepBlock = true;
 
 		std::ptrdiff_t disp = handle->TramPtr - handle->CavePtr - sizeof(asmDetour);
 		assert_trampoline_range(disp);
@@ -109,8 +143,7 @@ namespace DKUtil::Hook
 		AsMemCpy(handle->CaveBuf.data(), asmDetour);
 
 		if (a_flag.any(HookFlag::kRestoreBeforeProlog)) {
-			handle->Write(handle->OldBytes.data(), handle->CaveSize);
-			asmBranch.Disp -= static_cast<Disp32>(handle->CaveSize);
+			asmBranch.Disp -= static_cast<Disp32>(handle->WriteOldBytes());
 
 			a_flag.reset(HookFlag::kRestoreBeforeProlog);
 		}
@@ -121,8 +154,7 @@ namespace DKUtil::Hook
 		}
 
 		if (a_flag.any(HookFlag::kRestoreAfterProlog)) {
-			handle->Write(handle->OldBytes.data(), handle->CaveSize);
-			asmBranch.Disp -= static_cast<Disp32>(handle->CaveSize);
+			asmBranch.Disp -= static_cast<Disp32>(handle->WriteOldBytes());
 
 			a_flag.reset(HookFlag::kRestoreBeforeEpilog, HookFlag::kRestoreAfterEpilog);
 		}
@@ -143,7 +175,7 @@ namespace DKUtil::Hook
 		handle->Write(asmAdd);
 
 		if (a_flag.any(HookFlag::kRestoreBeforeEpilog)) {
-			handle->Write(handle->OldBytes.data(), handle->CaveSize);
+			handle->WriteOldBytes();
 			a_flag.reset(HookFlag::kRestoreAfterEpilog);
 		}
 
@@ -152,7 +184,7 @@ namespace DKUtil::Hook
 		}
 
 		if (a_flag.any(HookFlag::kRestoreAfterEpilog)) {
-			handle->Write(handle->OldBytes.data(), handle->CaveSize);
+			handle->WriteOldBytes();
 		}
 
 		if (a_flag.any(HookFlag::kSkipNOP)) {
@@ -0,0 +1,385 @@
+#pragma once
+
+#if !defined(DKU_H_INTERNAL_IMPORTS)
+#	error Incorrect DKUtil::Hook internal import order.
+#endif
+
+namespace DKUtil::Hook
+{
+	/** \brief Owner of a call/jmp site that several handlers hook at once.
+	 * \brief The site is relocated once to a stub that jumps to a dispatch thunk. The thunk reads a table of handlers and
+	 * \brief the first detour, and whenever a handler is added or removed a new table is swapped in. The thunk calls every
+	 * \brief handler in priority order with the arguments of the call, then jumps to the highest priority detour, or to the
+	 * \brief original function. Each detour continues to the next detour or the original function through GetNext.
+	 * \brief Handlers receive the register arguments of the platform abi only, stack arguments are not forwarded to them,
+	 * \brief and their return values are discarded. Rel32 and rip indirect call/jmp sites are supported, not cave hooks.
+	 * \brief A site owned by a chain must not be hooked with write_call, AddRelHook or AddCaveHook, they assert on it.
+	 */
+	class HookChain
+	{
+	public:
+		using handler_id = std::size_t;
+
+		// returned by AddDetour, its next slot stays valid after the detour is removed
+		struct detour_t
+		{
+			constexpr operator handler_id() const noexcept { return Id; }
+
+			handler_id                         Id;
+			const std::atomic<std::uintptr_t>* Next;
+		};
+
+		HookChain(const HookChain&) = delete;
+		HookChain& operator=(const HookChain&) = delete;
+
+		/** \brief Get the chain of a site, it is created and takes over the site on first use.
+		 * \param a_site : Address of call/jmp instruction, E8/E9 rel32 or FF 15/FF 25 [rip]
+		 * \return HookChain& : chain of the site
+		 */
+		[[nodiscard]] static HookChain& At(const std::uintptr_t a_site) noexcept
+		{
+			auto&            chains = registry();
+			std::unique_lock guard{ chains.lock };
+
+			auto& chain = chains.sites[a_site];
+			if (!chain) {
+				chain.reset(new HookChain(a_site));
+			}
+
+			return *chain;
+		}
+
+		/** \brief Check if a chain with entries owns a call/jmp site within an address range
+		 * \param a_address : Beginning of range
+		 * \param a_size : Size of range
+		 * \return bool : true if the range overlaps a site owned by a chain
+		 */
+		[[nodiscard]] static bool Owns(const std::uintptr_t a_address, const std::size_t a_size) noexcept
+		{
+			auto&            chains = registry();
+			std::unique_lock guard{ chains.lock };
+
+			// sites are at most 6 bytes, a site beginning before the range may still overlap it
+			auto it = chains.sites.lower_bound(a_address - (std::min)(a_address, sizeof(CallRip) - 1));
+			for (; it != chains.sites.end() && it->first < a_address + a_size; ++it) {
+				if (it->first + it->second->OpSeqSize > a_address && it->second->size()) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/** \brief Add a handler called before the detours and the original function
+		 * \param a_funcInfo : FUNC_INFO or RT_INFO wrapped function, same arguments as the original function
+		 * \param a_priority : Handlers with higher priority are called first, same priority in insertion order
+		 * \return handler_id : id to remove the handler with
+		 */
+		handler_id AddHandler(const FuncInfo a_funcInfo, const std::int32_t a_priority = 0) noexcept
+		{
+			return add(a_funcInfo, a_priority, false).Id;
+		}
+
+		/** \brief Add a detour that replaces the original function, it calls GetNext to continue the chain
+		 * \param a_funcInfo : FUNC_INFO or RT_INFO wrapped function, same signature as the original function
+		 * \param a_priority : Detour with the highest priority is called by the site, same priority in insertion order
+		 * \return detour_t : id to remove the detour with and its next slot for GetNext
+		 */
+		detour_t AddDetour(const FuncInfo a_funcInfo, const std::int32_t a_priority = 0) noexcept
+		{
+			return add(a_funcInfo, a_priority, true);
+		}
+
+		/** \brief Remove a handler or detour, the site is restored when none is left
+		 * \return bool : false if the id is not in this chain
+		 */
+		bool Remove(const handler_id a_id) noexcept
+		{
+			std::unique_lock guard{ _lock };
+
+			const auto it = std::ranges::find(_entries, a_id, &Entry::id);
+			if (it == _entries.end()) {
+				return false;
+			}
+
+			// detours may still be running, their next slot is kept valid and keeps its last target
+			if (it->next) {
+				_retiredNext.emplace_back(std::move(it->next));
+			}
+			_entries.erase(it);
+			rebuild();
+
+			return true;
+		}
+
+		// next detour or the original function after a detour, changes when the chain changes, lock free
+		template <typename F>
+		[[nodiscard]] static F GetNext(const detour_t a_detour) noexcept
+		{
+			return std::bit_cast<F>(a_detour.Next->load(std::memory_order_acquire));
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept
+		{
+			std::unique_lock guard{ _lock };
+			return _entries.size();
+		}
+
+		const std::uintptr_t Address;
+		const std::size_t    OpSeqSize;
+		const Imm64          OriginalFunc;
+
+	private:
+		struct Entry
+		{
+			handler_id                                   id;
+			std::int32_t                                 priority;
+			std::uintptr_t                               address;
+			std::unique_ptr<std::atomic<std::uintptr_t>> next;
+		};
+
+		// table : [callee][count][handlers...], published whole and never modified
+		static constexpr std::size_t TABLE_CALLEE = 0x0;
+		static constexpr std::size_t TABLE_COUNT = 0x8;
+		static constexpr std::size_t TABLE_HANDLERS = 0x10;
+
+		// reads the table once per call, saves the register arguments once, restores them for every handler
+		class Dispatch : public Xbyak::CodeGenerator
+		{
+		public:
+#if defined(_WIN32)
+			// shadow space, rcx rdx r8 r9, xmm0-3, table, index
+			static constexpr std::size_t HOME = 0x20;
+			static constexpr std::size_t XMM_ARGS = 4;
+			static constexpr std::size_t TABLE = 0x80;
+			static constexpr std::size_t FRAME = 0x98;
+#else
+			// rdi rsi rdx rcx r8 r9, xmm0-7, table, index
+			static constexpr std::size_t HOME = 0x0;
+			static constexpr std::size_t XMM_ARGS = 8;
+			static constexpr std::size_t TABLE = 0xB0;
+			static constexpr std::size_t FRAME = 0xC8;
+#endif
+			static constexpr std::size_t INDEX = TABLE + sizeof(std::uint64_t);
+			static_assert(FRAME % 0x10 == 0x8 && INDEX < FRAME);
+
+			explicit Dispatch(const std::uintptr_t a_table) :
+				Xbyak::CodeGenerator(0x200)
+			{
+				Xbyak::Label table;
+				Xbyak::Label dispatch;
+				Xbyak::Label next;
+
+				// detours only, straight to the first detour
+				mov(r11, qword[rip + table]);
+				mov(r11, qword[r11]);
+				cmp(qword[r11 + TABLE_COUNT], 0);
+				jne(dispatch);
+				jmp(qword[r11 + TABLE_CALLEE]);
+
+				// rsp is aligned for calls
+				L(dispatch);
+				sub(rsp, FRAME);
+				spill(true);
+				mov(qword[rsp + TABLE], r11);
+				mov(qword[rsp + INDEX], 0);
+
+				L(next);
+				mov(r10, qword[rsp + INDEX]);
+				call(qword[r11 + r10 * 8 + TABLE_HANDLERS]);
+				spill(false);
+				mov(r11, qword[rsp + TABLE]);
+				mov(r10, qword[rsp + INDEX]);
+				inc(r10);
+				mov(qword[rsp + INDEX], r10);
+				cmp(r10, qword[r11 + TABLE_COUNT]);
+				jb(next);
+
+				add(rsp, FRAME);
+				jmp(qword[r11 + TABLE_CALLEE]);
+
+				L(table);
+				dq(a_table);
+			}
+
+		private:
+			void spill(const bool a_save)
+			{
+#if defined(_WIN32)
+				const Xbyak::Reg64 gprs[] = { rcx, rdx, r8, r9 };
+#else
+				const Xbyak::Reg64 gprs[] = { rdi, rsi, rdx, rcx, r8, r9 };
+#endif
+
+				auto offset = HOME;
+				for (const auto& gpr : gprs) {
+					if (a_save) {
+						mov(qword[rsp + offset], gpr);
+					} else {
+						mov(gpr, qword[rsp + offset]);
+					}
+					offset += sizeof(std::uint64_t);
+				}
+
+				for (auto i = 0; i < static_cast<int>(XMM_ARGS); ++i) {
+					if (a_save) {
+						movdqu(xword[rsp + offset], Xbyak::Xmm(i));
+					} else {
+						movdqu(Xbyak::Xmm(i), xword[rsp + offset]);
+					}
+					offset += 0x10;
+				}
+			}
+		};
+
+		explicit HookChain(const std::uintptr_t a_site) noexcept :
+			Address(a_site),
+			OpSeqSize(op_size(a_site)),
+			OriginalFunc(GetDisp(a_site))
+		{
+			_oldBytes.resize(OpSeqSize);
+			std::memcpy(_oldBytes.data(), AsPointer(Address), OpSeqSize);
+
+			// [imm64 slot][jmp qword ptr [rip - 14]], slot is aligned for atomic swap
+			_stubSize = sizeof(Imm64) * 2 + sizeof(JmpRip) - 1;
+			_stub = TRAM_ALLOC_NEAR(_stubSize, Address);
+			_slot = numbers::roundup(_stub, sizeof(Imm64));
+
+			JmpRip asmBranch;
+			asmBranch.Disp -= static_cast<Disp32>(sizeof(Imm64));
+			asmBranch.Disp -= static_cast<Disp32>(sizeof(asmBranch));
+			AsMemCpy(_slot, OriginalFunc);
+			AsMemCpy(_slot + sizeof(Imm64), asmBranch);
+
+			__DEBUG("DKU_H: HookChain<{}> @ {:X}\ncall : {:X}\nstub : {:X}", OpSeqSize, Address, OriginalFunc, _slot + sizeof(Imm64));
+		}
+
+		[[nodiscard]] static std::size_t op_size(const std::uintptr_t a_site) noexcept
+		{
+			const auto* op = std::bit_cast<const OpCode*>(a_site);
+			if (op[0] == 0xE8 || op[0] == 0xE9) {
+				return sizeof(CallRel);
+			}
+
+			dku_assert(op[0] == 0xFF && (op[1] == 0x15 || op[1] == 0x25),
+				"DKU_H: HookChain site {:X} is not a rel32 or rip indirect call/jmp\nread-in : 0x{:2X}", a_site, op[0]);
+
+			return sizeof(CallRip);
+		}
+
+		detour_t add(const FuncInfo a_funcInfo, const std::int32_t a_priority, const bool a_detour) noexcept
+		{
+			if (!a_funcInfo.address()) {
+				ERROR("DKU_H: HookChain handler must have a valid function pointer");
+			}
+			__DEBUG("DKU_H: HookChain @ {:X} {} -> {} @ {}.{:X}", Address, a_detour ? "detour" : "handler", a_funcInfo.name().data(), PROJECT_NAME, a_funcInfo.address());
+
+			std::unique_lock guard{ _lock };
+
+			Entry entry{ ++_lastId, a_priority, a_funcInfo.address(), nullptr };
+			if (a_detour) {
+				entry.next = std::make_unique<std::atomic<std::uintptr_t>>(OriginalFunc);
+			}
+
+			const detour_t detour{ entry.id, entry.next.get() };
+
+			const auto it = std::ranges::upper_bound(_entries, a_priority, std::ranges::greater{}, &Entry::priority);
+			_entries.insert(it, std::move(entry));
+			rebuild();
+
+			return detour;
+		}
+
+		void rebuild() noexcept
+		{
+			std::vector<std::uintptr_t>  handlers;
+			std::uintptr_t               callee = OriginalFunc;
+			std::atomic<std::uintptr_t>* last = nullptr;
+			for (auto& entry : _entries) {
+				if (!entry.next) {
+					handlers.push_back(entry.address);
+					continue;
+				}
+
+				// detours are linked in priority order, the last continues to the original function
+				if (last) {
+					last->store(entry.address, std::memory_order_release);
+				} else {
+					callee = entry.address;
+				}
+				last = entry.next.get();
+			}
+
+			if (last) {
+				last->store(OriginalFunc, std::memory_order_release);
+			}
+
+			if (_entries.empty()) {
+				if (_installed) {
+					WriteData(Address, _oldBytes.data(), _oldBytes.size(), false);
+					_installed = false;
+					__DEBUG("DKU_H: HookChain @ {:X} restored", Address);
+				}
+
+				std::atomic_ref{ *std::bit_cast<std::uintptr_t*>(_slot) }.store(OriginalFunc, std::memory_order_release);
+				return;
+			}
+
+			// one thunk per chain, previous tables may still be read by calls in flight and are kept
+			auto table = std::make_unique<std::uintptr_t[]>(handlers.size() + TABLE_HANDLERS / sizeof(std::uintptr_t));
+			table[TABLE_CALLEE / sizeof(std::uintptr_t)] = callee;
+			table[TABLE_COUNT / sizeof(std::uintptr_t)] = handlers.size();
+			std::ranges::copy(handlers, table.get() + TABLE_HANDLERS / sizeof(std::uintptr_t));
+			_table.store(table.get(), std::memory_order_release);
+			_tables.emplace_back(std::move(table));
+
+			if (!_thunk) {
+				Dispatch dispatch{ AsAddress(std::addressof(_table)) };
+				_thunk = TRAM_ALLOC(dispatch.getSize());
+				std::memcpy(AsPointer(_thunk), dispatch.getCode(), dispatch.getSize());
+			}
+			std::atomic_ref{ *std::bit_cast<std::uintptr_t*>(_slot) }.store(_thunk, std::memory_order_release);
+
+			if (!_installed) {
+				std::vector<OpCode> detour(OpSeqSize, NOP);
+				const auto          disp = static_cast<std::ptrdiff_t>(_slot + sizeof(Imm64) - Address - sizeof(CallRel));
+				assert_trampoline_range(disp);
+
+				// rip indirect sites keep their call/jmp kind
+				const bool retn = _oldBytes[0] == 0xE8 || (_oldBytes[0] == 0xFF && _oldBytes[1] == 0x15);
+				detour[0] = retn ? 0xE8 : 0xE9;
+				AsMemCpy(detour.data() + 1, static_cast<Disp32>(disp));
+
+				WriteData(Address, detour.data(), detour.size(), false);
+				_installed = true;
+			}
+
+			__DEBUG("DKU_H: HookChain @ {:X} dispatches {} handlers -> {:X}", Address, handlers.size(), callee);
+		}
+
+		struct Registry
+		{
+			std::mutex                                           lock;
+			std::map<std::uintptr_t, std::unique_ptr<HookChain>> sites;
+		};
+
+		[[nodiscard]] static Registry& registry() noexcept
+		{
+			static Registry chains;
+			return chains;
+		}
+
+		mutable std::mutex                                        _lock;
+		std::vector<Entry>                                        _entries;
+		std::vector<std::unique_ptr<std::atomic<std::uintptr_t>>> _retiredNext;
+		std::vector<std::unique_ptr<std::uintptr_t[]>>            _tables;
+		std::atomic<const std::uintptr_t*>                        _table{ nullptr };
+		std::vector<OpCode>                                       _oldBytes;
+		std::uintptr_t                                            _stub{ 0 };
+		std::size_t                                               _stubSize{ 0 };
+		std::uintptr_t                                            _slot{ 0 };
+		std::uintptr_t                                            _thunk{ 0 };
+		handler_id                                                _lastId{ 0 };
+		bool                                                      _installed{ false };
+	};
+}  // namespace DKUtil::Hook
@@ -0,0 +1,164 @@
+#pragma once
+
+#if !defined(DKU_H_INTERNAL_IMPORTS)
+#	error Incorrect DKUtil::Hook internal import order.
+#endif
+
+namespace DKUtil::Hook
+{
+	/** \brief Call counters of hooks added with HookFlag::kProfile.
+	 * \brief A profiled hook calls its function through a thunk that reads the time stamp counter before and after the call,
+	 * \brief and atomically adds to the calls, total cycles and max cycles of that hook. Each hook owns one cache line of
+	 * \brief counters, so threads running different hooks never contend on the same line.
+	 * \brief The thunk forwards register arguments and up to PROFILE_STACK_ARGS stack arguments, return values in rax/rdx
+	 * \brief and xmm0/xmm1 are kept. Cycles include the thunk itself, a few dozen cycles per call.
+	 */
+	class HookStats
+	{
+	public:
+		static constexpr std::size_t CACHE_LINE = 0x40;
+		static constexpr std::size_t PROFILE_STACK_ARGS = 12;
+
+		struct alignas(CACHE_LINE) Counter
+		{
+			std::atomic<std::uint64_t> Calls{ 0 };
+			std::atomic<std::uint64_t> Cycles{ 0 };
+			std::atomic<std::uint64_t> MaxCycles{ 0 };
+		};
+		static_assert(sizeof(Counter) == CACHE_LINE);
+		static_assert(offsetof(Counter, Cycles) == 0x8 && offsetof(Counter, MaxCycles) == 0x10);
+
+		struct Entry
+		{
+			[[nodiscard]] constexpr double AverageCycles() const noexcept
+			{
+				return Calls ? static_cast<double>(Cycles) / static_cast<double>(Calls) : 0.0;
+			}
+
+			std::string    Name;
+			std::uintptr_t Address;
+			std::uint64_t  Calls;
+			std::uint64_t  Cycles;
+			std::uint64_t  MaxCycles;
+		};
+
+		/** \brief Read the counters of every profiled hook, in the order the hooks were added
+		 * \return std::vector<Entry> : name of hook function, hooked address and counters
+		 */
+		[[nodiscard]] static std::vector<Entry> Snapshot() noexcept
+		{
+			auto&            stats = storage();
+			std::unique_lock guard{ stats.lock };
+
+			std::vector<Entry> entries;
+			entries.reserve(stats.counters.size());
+			for (std::size_t i = 0; i < stats.counters.size(); ++i) {
+				const auto& counter = stats.counters[i];
+				entries.emplace_back(
+					stats.sites[i].first, stats.sites[i].second,
+					counter.Calls.load(std::memory_order_relaxed),
+					counter.Cycles.load(std::memory_order_relaxed),
+					counter.MaxCycles.load(std::memory_order_relaxed));
+			}
+
+			return entries;
+		}
+
+		// counters are zeroed one by one, calls in flight may land on either side
+		static void Reset() noexcept
+		{
+			auto&            stats = storage();
+			std::unique_lock guard{ stats.lock };
+
+			for (auto& counter : stats.counters) {
+				counter.Calls.store(0, std::memory_order_relaxed);
+				counter.Cycles.store(0, std::memory_order_relaxed);
+				counter.MaxCycles.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		/** \brief Generate a profiling thunk that calls a function and counts into a new counter
+		 * \param a_callee : Function called by the thunk
+		 * \param a_address : Hooked address the counter is reported with
+		 * \param a_name : Name the counter is reported with
+		 * \return std::uintptr_t : entry of thunk, called in place of a_callee
+		 */
+		[[nodiscard]] static std::uintptr_t MakeThunk(
+			const std::uintptr_t   a_callee,
+			const std::uintptr_t   a_address,
+			const std::string_view a_name) noexcept
+		{
+			auto&            stats = storage();
+			std::unique_lock guard{ stats.lock };
+
+			// counters and thunks are never freed, a disabled hook may still be returning through its thunk
+			auto& counter = stats.counters.emplace_back();
+			stats.sites.emplace_back(a_name, a_address);
+
+			ProfileThunk thunk{ a_callee, AsAddress(std::addressof(counter)) };
+			const auto   tramBlock = TRAM_ALLOC(sizeof(thunk));
+			std::memcpy(AsPointer(tramBlock), std::addressof(thunk), sizeof(thunk));
+
+			__DEBUG("DKU_H: Profile thunk @ {:X} -> {:X}\ncounter : {:X}", tramBlock + sizeof(Imm64), a_callee, AsAddress(std::addressof(counter)));
+			return tramBlock + sizeof(Imm64);
+		}
+
+	private:
+#if defined(_WIN32)
+		static constexpr std::size_t HOME = 0x20;
+#else
+		static constexpr std::size_t HOME = 0x0;
+#endif
+		static constexpr std::size_t FRAME = HOME + PROFILE_STACK_ARGS * sizeof(Imm64);
+		static_assert(FRAME % 0x10 == 0);
+
+#pragma pack(push, 1)
+		// rbx keeps the start stamp across the call, r10/r11 carry rax/rdx around rdtsc
+		struct ProfileThunk
+		{
+			constexpr ProfileThunk(const Imm64 a_callee, const Imm64 a_counter) noexcept :
+				Callee(a_callee), Stats(a_counter)
+			{
+				Call.Disp = -static_cast<Disp32>(offsetof(ProfileThunk, Call) + sizeof(CallRip));
+			}
+
+			Imm64    Callee;
+			// push rbx | mov r10, rax | mov r11, rdx | rdtsc | shl rdx, 32 | or rax, rdx | mov rbx, rax | mov rax, r10 | mov rdx, r11
+			OpCode   Start[25] = { 0x53, 0x49, 0x89, 0xC2, 0x49, 0x89, 0xD3, 0x0F, 0x31, 0x48, 0xC1, 0xE2, 0x20, 0x48, 0x09, 0xD0, 0x48, 0x89, 0xC3, 0x4C, 0x89, 0xD0, 0x4C, 0x89, 0xDA };
+			SubRspEx Alloc{ static_cast<Imm32>(FRAME) };
+			// mov r11d, args | loop: mov r10, [rsp + r11 * 8 + src] | mov [rsp + r11 * 8 + dst], r10 | dec r11 | jnz loop
+			OpCode   CopyCount[2] = { 0x41, 0xBB };
+			Imm32    Count = PROFILE_STACK_ARGS;
+			OpCode   CopyLoad[4] = { 0x4E, 0x8B, 0x94, 0xDC };
+			Disp32   Src = static_cast<Disp32>(FRAME + sizeof(Imm64) * 2 + HOME - sizeof(Imm64));
+			OpCode   CopyStore[4] = { 0x4E, 0x89, 0x94, 0xDC };
+			Disp32   Dst = static_cast<Disp32>(HOME - sizeof(Imm64));
+			OpCode   CopyNext[5] = { 0x49, 0xFF, 0xCB, 0x75, 0xEB };
+			CallRip  Call{};
+			AddRspEx Dealloc{ static_cast<Imm32>(FRAME) };
+			// mov r10, rax | mov r11, rdx | rdtscp | shl rdx, 32 | or rax, rdx | sub rax, rbx | mov rbx, rax | mov rcx, imm64
+			OpCode   Stop[24] = { 0x49, 0x89, 0xC2, 0x49, 0x89, 0xD3, 0x0F, 0x01, 0xF9, 0x48, 0xC1, 0xE2, 0x20, 0x48, 0x09, 0xD0, 0x48, 0x29, 0xD8, 0x48, 0x89, 0xC3, 0x48, 0xB9 };
+			Imm64    Stats;
+			// lock inc [rcx] | lock add [rcx + 8], rbx | mov rax, [rcx + 0x10]
+			// retry: cmp rbx, rax | jbe done | lock cmpxchg [rcx + 0x10], rbx | jnz retry
+			// done: mov rax, r10 | mov rdx, r11 | pop rbx | ret
+			OpCode   Update[34] = { 0xF0, 0x48, 0xFF, 0x01, 0xF0, 0x48, 0x01, 0x59, 0x08, 0x48, 0x8B, 0x41, 0x10,
+				0x48, 0x39, 0xC3, 0x76, 0x08, 0xF0, 0x48, 0x0F, 0xB1, 0x59, 0x10, 0x75, 0xF3,
+				0x4C, 0x89, 0xD0, 0x4C, 0x89, 0xDA, 0x5B, 0xC3 };
+		};
+#pragma pack(pop)
+
+		struct Storage
+		{
+			std::mutex                                          lock;
+			std::deque<Counter>                                 counters;
+			std::vector<std::pair<std::string, std::uintptr_t>> sites;
+		};
+
+		[[nodiscard]] static Storage& storage() noexcept
+		{
+			static Storage stats;
+			return stats;
+		}
+	};
+}  // namespace DKUtil::Hook
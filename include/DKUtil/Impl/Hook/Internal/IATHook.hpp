@@ -28,12 +28,14 @@ namespace DKUtil::Hook
 		void Enable() noexcept override
 		{
 			WriteImm(Address, TramEntry, false);
+			Enabled = true;
 			__DEBUG("DKU_H: Enabled IAT hook");
 		}
 
 		void Disable() noexcept override
 		{
 			WriteImm(Address, OldAddress, false);
+			Enabled = false;
 			__DEBUG("DKU_H: Disabled IAT hook");
 		}
 
@@ -57,21 +59,23 @@ namespace DKUtil::Hook
 		const auto iat = AsAddress(GetImportAddress(a_moduleName, a_libraryName, a_importName));
 
 		if (a_patch.first && a_patch.second) {
-			auto tramPtr = TRAM_ALLOC(0);
+			// [imm64][patch][call qword ptr [rip - size]], shared by hooks with the same patch and function
+			const auto tramSize = sizeof(Imm64) + a_patch.second + sizeof(CallRip);
 
-			CallRip asmBranch;
-
-			WriteImm(tramPtr, a_funcInfo.address(), true);
-			tramPtr += sizeof(a_funcInfo.address());
-			asmBranch.Disp -= static_cast<Disp32>(sizeof(Imm64));
+			std::vector<OpCode> thunk(tramSize);
+			AsMemCpy(thunk.data(), a_funcInfo.address());
+			std::memcpy(thunk.data() + sizeof(Imm64), a_patch.first, a_patch.second);
 
-			auto handle = std::make_unique<IATHookHandle>(iat, tramPtr, a_importName, a_funcInfo.name().data());
+			CallRip asmBranch;
+			asmBranch.Disp -= static_cast<Disp32>(tramSize);
+			AsMemCpy(thunk.data() + sizeof(Imm64) + a_patch.second, asmBranch);
 
-			handle->Write(a_patch.first, a_patch.second);
-			asmBranch.Disp -= static_cast<Disp32>(a_patch.second);
+			const auto tramBlock = TRAM_INTERN(thunk.data(), tramSize, std::uintptr_t{ 0 });
 
-			asmBranch.Disp -= static_cast<Disp32>(sizeof(asmBranch));
-			handle->Write(asmBranch);
+			auto handle = std::make_unique<IATHookHandle>(iat, tramBlock + sizeof(Imm64), a_importName, a_funcInfo.name().data());
+			handle->TramBlock = tramBlock;
+			handle->TramSize = tramSize;
+			handle->TramPtr = tramBlock + tramSize;
 
 			return std::move(handle);
 		} else {
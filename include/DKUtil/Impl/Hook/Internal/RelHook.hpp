@@ -30,12 +30,14 @@ namespace DKUtil::Hook
 		void Enable() noexcept override
 		{
 			WriteData(Address, Detour.data(), Detour.size(), false);
+			Enabled = true;
 			__DEBUG("DKU_H: Enabled relocation hook @ {:X}", Address);
 		}
 
 		void Disable() noexcept override
 		{
 			WriteData(Address, OldBytes.data(), OldBytes.size(), false);
+			Enabled = false;
 			__DEBUG("DKU_H: Disabled relocation hook @ {:X}", Address);
 		}
 
@@ -58,24 +60,47 @@ namespace DKUtil::Hook
 	 * \param <RETN> : Return or branch (call/jmp)
 	 * \param a_src : Address of call/jmp instruction
 	 * \param a_dst : Destination function
+	 * \param a_flag : HookFlag::kProfile counts calls of destination in HookStats, named by its address
 	 * \return RelHookHandle
 	 */
 	template <std::size_t N, bool RETN>
 	inline auto AddRelHook(
-		std::uintptr_t a_src,
-		std::uintptr_t a_dst)  // noexcept
+		std::uintptr_t               a_src,
+		std::uintptr_t               a_dst,
+		model::enumeration<HookFlag> a_flag = HookFlag::kNoFlag)  // noexcept
 	{
 		static_assert(N == 5 || N == 6, "unsupported instruction size");
+		dku_assert(!HookChain::Owns(a_src, N),
+			"DKU_H: Relocation site {:X} is owned by a HookChain, add a detour to the chain instead", a_src);
 		using DetourAsm = std::conditional_t<N == 5, _BranchNear<RETN>, _BranchIndirect<RETN>>;
 
-		auto tramPtr = TRAM_ALLOC(0);
+		constexpr auto tramSize = sizeof(a_dst) + (N == 5 ? sizeof(JmpRip) : 0);
 
-		// tram entry
-		WriteImm(tramPtr, a_dst, true);
-		tramPtr += sizeof(a_dst);
+		// tram entry, position independent and shared by all hooks to the same destination
+		// profiled destination has no FUNC_INFO, it is reported by address
+		std::array<OpCode, tramSize> thunk{};
+		if (a_flag.any(HookFlag::kProfile)) {
+			AsMemCpy(thunk.data(), HookStats::MakeThunk(a_dst, a_src, fmt::format("{}.{:X}", PROJECT_NAME, a_dst)));
+		} else {
+			AsMemCpy(thunk.data(), a_dst);
+		}
+
+		if constexpr (N == 5) {
+			// branch
+			JmpRip asmBranch;
+			asmBranch.Disp -= static_cast<Disp32>(sizeof(Imm64));
+			asmBranch.Disp -= static_cast<Disp32>(sizeof(asmBranch));
+			AsMemCpy(thunk.data() + sizeof(a_dst), asmBranch);
+		}
+
+		const auto tramBlock = TRAM_INTERN(thunk.data(), tramSize, a_src);
+		const auto tramPtr = tramBlock + sizeof(a_dst);
 
 		// handle
 		auto handle = std::make_unique<RelHookHandle>(a_src, tramPtr, a_dst, N);
+		handle->TramBlock = tramBlock;
+		handle->TramSize = tramSize;
+		handle->TramPtr = tramBlock + tramSize;
 		handle->OldBytes.resize(N);
 		std::memcpy(handle->OldBytes.data(), AsPointer(a_src), N);
 		handle->Detour.resize(N, NOP);
@@ -91,15 +116,6 @@ namespace DKUtil::Hook
 		asmDetour.Disp = static_cast<Disp32>(disp);
 		AsMemCpy(handle->Detour.data(), asmDetour);
 
-		if constexpr (N == 5) {
-			// branch
-			JmpRip asmBranch;
-			asmBranch.Disp -= static_cast<Disp32>(sizeof(Imm64));
-			asmBranch.Disp -= static_cast<Disp32>(sizeof(asmBranch));
-
-			handle->Write(asmBranch);
-		}
-
 		return std::move(handle);
 	}
 }  // namespace DKUtil::Hook
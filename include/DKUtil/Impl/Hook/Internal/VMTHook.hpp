@@ -24,12 +24,14 @@ namespace DKUtil::Hook
 		void Enable() noexcept override
 		{
 			WriteImm(Address, TramEntry, false);
+			Enabled = true;
 			__DEBUG("DKU_H: Enabled VMT hook");
 		}
 
 		void Disable() noexcept override
 		{
 			WriteImm(Address, OldAddress, false);
+			Enabled = false;
 			__DEBUG("DKU_H: Disabled VMT hook");
 		}
 
@@ -47,40 +49,197 @@ namespace DKUtil::Hook
 	 * \param a_index : Index of the virtual function in the virtual method table
 	 * \param a_funcInfo : FUNC_INFO or RT_INFO wrapped function
 	 * \param a_patch : Prolog patch before detouring to target function
+	 * \param a_flag : HookFlag::kProfile counts calls of target function in HookStats
 	 * @return VMTHookHandle
 	 */
 	[[nodiscard]] inline auto AddVMTHook(
-		const void*         a_vtbl,
-		const std::uint16_t a_index,
-		const FuncInfo      a_funcInfo,
-		const unpacked_data a_patch = std::make_pair(nullptr, 0)) noexcept
+		const void*                  a_vtbl,
+		const std::uint16_t          a_index,
+		const FuncInfo               a_funcInfo,
+		const unpacked_data          a_patch = std::make_pair(nullptr, 0),
+		model::enumeration<HookFlag> a_flag = HookFlag::kNoFlag) noexcept
 	{
 		if (!a_funcInfo.address()) {
 			ERROR("DKU_H: VMT hook must have a valid function pointer");
 		}
 		__DEBUG("DKU_H: Detour -> {} @ {}.{:X}", a_funcInfo.name().data(), PROJECT_NAME, a_funcInfo.address());
 
-		if (a_patch.first && a_patch.second) {
-			auto tramPtr = TRAM_ALLOC(0);
+		const auto vtbl = *std::bit_cast<const std::uintptr_t*>(a_vtbl);
+		const auto callee = a_flag.any(HookFlag::kProfile) ?
+		                    HookStats::MakeThunk(a_funcInfo.address(), TblToAbs(vtbl, a_index), a_funcInfo.name()) :
+		                    a_funcInfo.address();
 
-			CallRip asmBranch;
+		if (a_patch.first && a_patch.second) {
+			// [imm64][patch][call qword ptr [rip - size]], shared by hooks with the same patch and function
+			const auto tramSize = sizeof(Imm64) + a_patch.second + sizeof(CallRip);
 
-			WriteImm(tramPtr, a_funcInfo.address(), true);
-			tramPtr += sizeof(a_funcInfo.address());
-			asmBranch.Disp -= static_cast<Disp32>(sizeof(Imm64));
+			std::vector<OpCode> thunk(tramSize);
+			AsMemCpy(thunk.data(), callee);
+			std::memcpy(thunk.data() + sizeof(Imm64), a_patch.first, a_patch.second);
 
-			auto handle = std::make_unique<VMTHookHandle>(*std::bit_cast<std::uintptr_t*>(a_vtbl), tramPtr, a_index);
+			CallRip asmBranch;
+			asmBranch.Disp -= static_cast<Disp32>(tramSize);
+			AsMemCpy(thunk.data() + sizeof(Imm64) + a_patch.second, asmBranch);
 
-			handle->Write(a_patch.first, a_patch.second);
-			asmBranch.Disp -= static_cast<Disp32>(a_patch.second);
+			const auto tramBlock = TRAM_INTERN(thunk.data(), tramSize, std::uintptr_t{ 0 });
 
-			asmBranch.Disp -= static_cast<Disp32>(sizeof(asmBranch));
-			handle->Write(asmBranch);
+			auto handle = std::make_unique<VMTHookHandle>(vtbl, tramBlock + sizeof(Imm64), a_index);
+			handle->TramBlock = tramBlock;
+			handle->TramSize = tramSize;
+			handle->TramPtr = tramBlock + tramSize;
 
 			return std::move(handle);
 		} else {
-			auto handle = std::make_unique<VMTHookHandle>(*std::bit_cast<std::uintptr_t*>(a_vtbl), a_funcInfo.address(), a_index);
+			auto handle = std::make_unique<VMTHookHandle>(vtbl, callee, a_index);
 			return std::move(handle);
 		}
 	}
+
+	/** \brief Per object vtable swap, only the hooked object dispatches to the overrides.
+	 * \brief The object's vptr is swapped to a clone of its vtable with the overrides applied, other objects of the class keep
+	 * \brief the original vtable. Clones keep the rtti prefix of the vtable, so typeid and dynamic_cast still work.
+	 */
+	class VMTShadowHandle : public HookHandle
+	{
+	public:
+		// object address, shadow vtable address, original vtable address
+		VMTShadowHandle(
+			const std::uintptr_t a_object,
+			const std::uintptr_t a_shadow,
+			const std::uintptr_t a_vtbl) noexcept :
+			HookHandle(a_object, a_shadow),
+			OldAddress(a_vtbl)
+		{
+			__DEBUG("DKU_H: VMT shadow @ {:X}\nOld vtbl @ {:X} | New vtbl @ {:X}", a_object, OldAddress, TramEntry);
+		}
+
+		void Enable() noexcept override
+		{
+			std::atomic_ref{ *std::bit_cast<std::uintptr_t*>(Address) }.store(TramEntry);
+			Enabled = true;
+			__DEBUG("DKU_H: Enabled VMT shadow");
+		}
+
+		// vptr is only restored if it still points to the shadow vtable
+		void Disable() noexcept override
+		{
+			auto expected = TramEntry;
+			std::atomic_ref{ *std::bit_cast<std::uintptr_t*>(Address) }.compare_exchange_strong(expected, OldAddress);
+			Enabled = false;
+			__DEBUG("DKU_H: Disabled VMT shadow");
+		}
+
+		template <typename F>
+		F GetOldFunction(const std::uint16_t a_index) noexcept
+		{
+			return std::bit_cast<F>(std::bit_cast<const std::uintptr_t*>(OldAddress)[a_index]);
+		}
+
+		const std::uintptr_t OldAddress;
+	};
+
+	namespace detail
+	{
+		// msvc abi keeps the complete object locator before the vtable, itanium abi the offset to top and type info
+#if defined(_MSC_VER)
+		inline constexpr std::size_t VTBL_PREFIX = 1;
+#else
+		inline constexpr std::size_t VTBL_PREFIX = 2;
+#endif
+
+		// vtable ends at the first entry that is not executable code, e.g. the rtti prefix of the next vtable
+		[[nodiscard]] inline std::size_t vtable_size(const std::uintptr_t* a_vtbl) noexcept
+		{
+			constexpr std::size_t maxEntries = 0x400;
+
+			Platform::MemoryRegion region{};
+			std::size_t            size = 0;
+			for (void(0); size < maxEntries && a_vtbl[size]; ++size) {
+				const auto entry = a_vtbl[size];
+				if (entry < region.base || entry - region.base >= region.size) {
+					region = Platform::query(entry);
+				}
+
+				if (region.free || !Platform::executable(region.protect)) {
+					break;
+				}
+			}
+
+			return size;
+		}
+
+		// clones are shared by original vtable and overrides, and never freed as objects may still dispatch through them
+		[[nodiscard]] inline std::uintptr_t shadow_vtable(
+			const std::uintptr_t                                  a_vtbl,
+			std::vector<std::pair<std::uint16_t, std::uintptr_t>> a_overrides,
+			const std::size_t                                     a_size) noexcept
+		{
+			using key_t = std::pair<std::uintptr_t, std::vector<std::pair<std::uint16_t, std::uintptr_t>>>;
+
+			static std::map<key_t, std::unique_ptr<std::uintptr_t[]>> clones;
+			static std::mutex                                         lock;
+
+			std::ranges::sort(a_overrides);
+			std::unique_lock guard{ lock };
+
+			auto [it, inserted] = clones.try_emplace(key_t{ a_vtbl, a_overrides });
+			if (inserted) {
+				const auto* original = std::bit_cast<const std::uintptr_t*>(a_vtbl);
+				const auto  size = a_size ? a_size : vtable_size(original);
+
+				auto clone = std::make_unique<std::uintptr_t[]>(VTBL_PREFIX + size);
+				std::copy_n(original - VTBL_PREFIX, VTBL_PREFIX + size, clone.get());
+				for (const auto& [index, address] : a_overrides) {
+					dku_assert(index < size,
+						"DKU_H: VMT shadow index {} exceeds vtable size {}\nvtbl : {:X}", index, size, a_vtbl);
+					clone[VTBL_PREFIX + index] = address;
+				}
+
+				__DEBUG("DKU_H: Cloned vtbl @ {:X} with {} entries, {} overrides", a_vtbl, size, a_overrides.size());
+				it->second = std::move(clone);
+			}
+
+			return AsAddress(it->second.get() + VTBL_PREFIX);
+		}
+	}  // namespace detail
+
+	/** \brief Swaps the vtable of a single object with a shadow copy that has the overrides applied
+	 * \param a_object : Pointer to class object, vptr is at offset 0
+	 * \param a_overrides : Index of virtual function and FUNC_INFO or RT_INFO wrapped function pairs
+	 * \param a_size : Number of vtable entries, detected from the vtable if 0
+	 * \return VMTShadowHandle
+	 */
+	[[nodiscard]] inline auto AddVMTShadowHook(
+		void*                                                     a_object,
+		std::initializer_list<std::pair<std::uint16_t, FuncInfo>> a_overrides,
+		const std::size_t                                         a_size = 0) noexcept
+	{
+		std::vector<std::pair<std::uint16_t, std::uintptr_t>> overrides;
+		for (const auto& [index, funcInfo] : a_overrides) {
+			if (!funcInfo.address()) {
+				ERROR("DKU_H: VMT shadow must have a valid function pointer");
+			}
+			__DEBUG("DKU_H: Detour [{}] -> {} @ {}.{:X}", index, funcInfo.name().data(), PROJECT_NAME, funcInfo.address());
+
+			overrides.emplace_back(index, funcInfo.address());
+		}
+
+		const auto vtbl = *std::bit_cast<std::uintptr_t*>(a_object);
+		return std::make_unique<VMTShadowHandle>(AsAddress(a_object), detail::shadow_vtable(vtbl, std::move(overrides), a_size), vtbl);
+	}
+
+	/** \brief Swaps the vtable of a single object with a shadow copy that has one function overridden
+	 * \param a_object : Pointer to class object, vptr is at offset 0
+	 * \param a_index : Index of the virtual function in the virtual method table
+	 * \param a_funcInfo : FUNC_INFO or RT_INFO wrapped function
+	 * \return VMTShadowHandle
+	 */
+	[[nodiscard]] inline auto AddVMTShadowHook(
+		void*               a_object,
+		const std::uint16_t a_index,
+		const FuncInfo      a_funcInfo,
+		const std::size_t   a_size = 0) noexcept
+	{
+		return AddVMTShadowHook(a_object, { std::make_pair(a_index, a_funcInfo) }, a_size);
+	}
 }  // namespace DKUtil::Hook
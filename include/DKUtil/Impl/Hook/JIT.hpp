@@ -1,6 +1,6 @@
 #pragma once
 
-#include "assembly.hpp"
+#include "Assembly.hpp"
 
 #define FUNC_INFO(FUNC)                           \
 	DKUtil::Hook::FuncInfo                        \
@@ -264,160 +264,471 @@ namespace DKUtil::Hook
 		using patch_descriptor = std::pair<Patch, Patch>;
 		using patch_block = std::pair<std::vector<OpCode>, std::size_t>;
 
-		/** \brief Allocates a block of memory and generates non volatile patch
-		 * \brief push/pop to preserve registers
-		 * \param a_regs : { reg1, reg2, reg3... } registers to preserve
-		 * \return patch_descriptor : a pair of views of prolog and epilog of this patch
-		 */
-		inline patch_descriptor MakeNonVolatilePatch(enumeration<Register> a_regs)
+		namespace detail
 		{
-			static std::unordered_map<Register, patch_block> Patches;
+			[[nodiscard]] inline constexpr std::uint32_t expand_flags(const std::uint32_t a_flags, const std::uint32_t a_none, const std::uint32_t a_all) noexcept
+			{
+				if (a_flags & a_none) {
+					return 0;
+				}
 
-			if (a_regs.any(Register::NONE)) {
-				return {};
+				// every flag between NONE and ALL
+				return (a_flags & a_all) ? (a_all - 1) & ~a_none : a_flags;
 			}
 
-			auto& [buf, end] = Patches[a_regs.get()];
+			[[nodiscard]] inline constexpr std::uint32_t expand(const std::uint32_t a_regs) noexcept
+			{
+				return expand_flags(a_regs, std::to_underlying(Register::NONE), std::to_underlying(Register::ALL));
+			}
 
-			if (buf.empty() || !end) {
-				// size
-				std::size_t bufSize{ 0 };
-#if defined(DKU_H_JIT_MAX_SIZE_BUFFER)
-				constexpr auto Block = std::bit_width(std::to_underlying(Register::ALL)) * sizeof(PushR64B);
-				bufSize = Block * 2;
-#else
-				for (auto reg : a_regs.flag_range(Register::RAX, Register::R15)) {
-					if (a_regs.any(reg, Register::ALL)) {
-						bufSize += (sizeof(PushR64B) + sizeof(PopR64B));
+			[[nodiscard]] inline constexpr std::uint32_t expand_simd(const std::uint32_t a_simds) noexcept
+			{
+				return expand_flags(a_simds, std::to_underlying(SIMD::NONE), std::to_underlying(SIMD::ALL));
+			}
+
+			// register index of a flag, RAX..RDI and R8..R15 are 0..7
+			[[nodiscard]] inline constexpr OpCode flag_index(const std::uint32_t a_flag, const std::uint32_t a_first) noexcept
+			{
+				return static_cast<OpCode>(std::bit_width(a_flag) - std::bit_width(a_first));
+			}
+
+			// requested vector width in bytes
+			[[nodiscard]] inline constexpr std::size_t requested_width(const std::uint32_t a_avx) noexcept
+			{
+				return (a_avx & std::to_underlying(AVX::ZMM)) ? 0x40 : (a_avx & std::to_underlying(AVX::YMM)) ? 0x20 : 0x10;
+			}
+
+			// widest requested vector width the os has enabled
+			[[nodiscard]] inline std::size_t vector_width(const std::uint32_t a_avx) noexcept
+			{
+				const auto width = requested_width(a_avx);
+				if (width == 0x40 && CPU::has_avx512()) {
+					return 0x40;
+				}
+
+				return width >= 0x20 && CPU::has_avx() ? 0x20 : 0x10;
+			}
+
+			// bytes moved per opmask, 8 with kmovq on avx512bw, 2 with kmovw on avx512f, 0 without opmasks
+			[[nodiscard]] inline std::size_t opmask_width() noexcept
+			{
+				return CPU::has_avx512bw() ? 0x8 : CPU::has_avx512() ? 0x2 : 0x0;
+			}
+
+			// writes prolog from the front and epilog from the back of the buffer, only counts sizes without buffer
+			class nonvolatile_encoder
+			{
+			public:
+				explicit constexpr nonvolatile_encoder(std::span<OpCode> a_buf) noexcept :
+					_buf(a_buf), _back(a_buf.size())
+				{}
+
+				[[nodiscard]] constexpr std::size_t size() const noexcept { return _front; }
+				[[nodiscard]] constexpr std::size_t epilog_size() const noexcept { return _epilog; }
+
+				constexpr void emit(std::initializer_list<OpCode> a_prolog, std::initializer_list<OpCode> a_epilog) noexcept
+				{
+					emit_bytes(a_prolog, a_epilog);
+				}
+
+				constexpr void emit_bytes(std::span<const OpCode> a_prolog, std::span<const OpCode> a_epilog) noexcept
+				{
+					if (!_buf.empty()) {
+						std::ranges::copy(a_prolog, _buf.begin() + _front);
+						std::ranges::copy(a_epilog, _buf.begin() + (_back - a_epilog.size()));
+						_back -= a_epilog.size();
 					}
+
+					_front += a_prolog.size();
+					_epilog += a_epilog.size();
 				}
-#endif
-				buf.resize(bufSize, INT3);
-				end = 0;
-
-				// 1 byte
-				for (auto reg : a_regs.flag_range(Register::RAX, Register::RDI)) {
-					if (a_regs.any(reg, Register::ALL)) {
-						buf[end++] = std::bit_cast<OpCode>(PushR64(reg));
-						buf[buf.size() - end] = std::bit_cast<OpCode>(PopR64(reg));
+
+				/** \brief [prefix] op modrm sib [disp], stores to rsp + offset in prolog and loads in epilog
+				 * \param a_scale : evex compressed disp8 scale
+				 */
+				constexpr void move(std::initializer_list<OpCode> a_prefix, const OpCode a_store, const OpCode a_load, const OpCode a_reg, const std::uint32_t a_offset, const std::uint32_t a_scale = 1) noexcept
+				{
+					const bool disp8 = a_offset % a_scale == 0 && a_offset / a_scale < 0x80;
+					const auto mod = static_cast<OpCode>(!a_offset ? 0x00 : disp8 ? 0x40 : 0x80);
+					const auto disp = disp8 ? a_offset / a_scale : a_offset;
+
+					std::array<OpCode, 0x10> store{};
+					std::size_t              size = a_prefix.size();
+					std::ranges::copy(a_prefix, store.begin());
+
+					store[size++] = a_store;
+					store[size++] = static_cast<OpCode>(mod | ((a_reg & 0x7) << 3) | 0x4);
+					store[size++] = 0x24;  // rsp
+
+					const auto dispSize = !a_offset ? 0 : disp8 ? sizeof(Disp8) : sizeof(Disp32);
+					for (std::size_t i = 0; i < dispSize; ++i) {
+						store[size++] = static_cast<OpCode>(disp >> (i * 8));
 					}
+
+					auto load = store;
+					load[a_prefix.size()] = a_load;
+
+					emit_bytes({ store.data(), size }, { load.data(), size });
 				}
 
-				if (a_regs.any(Register::RF, Register::ALL)) {
+			private:
+				std::span<OpCode> _buf;
+				std::size_t       _front{ 0 };
+				std::size_t       _back{ 0 };
+				std::size_t       _epilog{ 0 };
+			};
+
+			[[nodiscard]] inline constexpr std::array<OpCode, 4> imm32(const std::uint32_t a_imm) noexcept
+			{
+				return std::bit_cast<std::array<OpCode, 4>>(a_imm);
+			}
+
+			/** \brief Encode a non volatile patch, prolog is written from the front, epilog from the back
+			 * \brief Registers are pushed in ascending order, then simd registers and opmasks are moved to the stack in ascending order
+			 * \param a_regs : Register flags
+			 * \param a_simds : SIMD flags
+			 * \param a_buf : Buffer of 2 * prolog size, or empty to only count the prolog size
+			 * \param a_width : Vector width of SIMD registers in bytes, 0x10 xmm, 0x20 ymm, 0x40 zmm
+			 * \param a_opmask : Opmask width in bytes to preserve k0-k7 with, 0x8 kmovq, 0x2 kmovw, 0x0 none
+			 * \return std::size_t : bytes of prolog, epilog is of the same size
+			 */
+			inline constexpr std::size_t encode_nonvolatile(
+				const std::uint32_t a_regs,
+				const std::uint32_t a_simds,
+				std::span<OpCode>   a_buf,
+				const std::size_t   a_width = 0x10,
+				const std::size_t   a_opmask = 0x0) noexcept
+			{
+				const auto regs = expand(a_regs);
+				const auto simds = expand_simd(a_simds);
+
+				nonvolatile_encoder encoder{ a_buf };
+
+				// push r64 | pop r64
+				for (auto reg = std::to_underlying(Register::RAX); reg <= std::to_underlying(Register::RDI); reg <<= 1) {
+					if (regs & reg) {
+						const auto index = flag_index(reg, std::to_underlying(Register::RAX));
+						encoder.emit({ static_cast<OpCode>(0x50 + index) }, { static_cast<OpCode>(0x58 + index) });
+					}
+				}
+
+				if (regs & std::to_underlying(Register::RF)) {
 #if defined(DKU_H_JIT_ALT_PUSHFQ_POPFQ)
 					// rf: lahf sahf
-					if (a_regs.none(Register::RAX, Register::ALL)) {
-						buf[end++] = std::bit_cast<OpCode>(PushR64(Register::RAX));
-						buf[buf.size() - end] = std::bit_cast<OpCode>(PopR64(Register::RAX));
+					if (!(regs & std::to_underlying(Register::RAX))) {
+						encoder.emit({ 0x50 }, { 0x58 });
 					}
 
-					buf[end++] = std::bit_cast<OpCode>(PushR64(Register::RF)) + 0x3;
-					buf[buf.size() - end] = std::bit_cast<OpCode>(PopR64(Register::RF)) + 0x1;
-
-					buf[end++] = std::bit_cast<OpCode>(PushR64(Register::RAX));
-					buf[buf.size() - end] = std::bit_cast<OpCode>(PopR64(Register::RAX));
+					encoder.emit({ 0x9F }, { 0x9E });
+					encoder.emit({ 0x50 }, { 0x58 });
 #else
 					// rf: pushf popf
-					buf[end++] = std::bit_cast<OpCode>(PushR64(Register::RF));
-					buf[buf.size() - end] = std::bit_cast<OpCode>(PopR64(Register::RF));
+					encoder.emit({ 0x9C }, { 0x9D });
 #endif
 				}
 
-				// 2 bytes
-				for (auto reg : a_regs.flag_range(Register::R8, Register::R15)) {
-					if (a_regs.any(reg, Register::ALL)) {
-						AsMemCpy(buf.data() + end, PushR64B(reg));
-						end += 2;
-						AsMemCpy(buf.data() + buf.size() - end, PopR64B(reg));
+				// REX.B push r64 | pop r64
+				for (auto reg = std::to_underlying(Register::R8); reg <= std::to_underlying(Register::R15); reg <<= 1) {
+					if (regs & reg) {
+						const auto index = flag_index(reg, std::to_underlying(Register::R8));
+						encoder.emit({ 0x41, static_cast<OpCode>(0x50 + index) }, { 0x41, static_cast<OpCode>(0x58 + index) });
+					}
+				}
+
+				if (!simds && !a_opmask) {
+					return encoder.size();
+				}
+
+				// sub rsp, imm32 | add rsp, imm32
+				const auto stack = imm32(static_cast<std::uint32_t>(std::popcount(simds) * a_width + (a_opmask ? 8 * sizeof(std::uint64_t) : 0)));
+				encoder.emit({ 0x48, 0x81, 0xEC, stack[0], stack[1], stack[2], stack[3] }, { 0x48, 0x81, 0xC4, stack[0], stack[1], stack[2], stack[3] });
+
+				std::uint32_t offset{ 0 };
+				for (auto simd = std::to_underlying(SIMD::XMM0); simd <= std::to_underlying(SIMD::XMM15); simd <<= 1) {
+					if (!(simds & simd)) {
+						continue;
+					}
+
+					const auto index = flag_index(simd, std::to_underlying(SIMD::XMM0));
+					switch (a_width) {
+					case 0x40:
+						// vmovdqu64 [rsp + disp], zmm | vmovdqu64 zmm, [rsp + disp]
+						encoder.move({ 0x62, static_cast<OpCode>(index >= 8 ? 0x71 : 0xF1), 0xFE, 0x48 }, 0x7F, 0x6F, index, offset, 0x40);
+						break;
+					case 0x20:
+						// vmovdqu [rsp + disp], ymm | vmovdqu ymm, [rsp + disp]
+						encoder.move({ 0xC5, static_cast<OpCode>(index >= 8 ? 0x7E : 0xFE) }, 0x7F, 0x6F, index, offset);
+						break;
+					default:
+						// vmovdqu [rsp + disp], xmm | vmovdqu xmm, [rsp + disp]
+						encoder.move({ 0xC5, static_cast<OpCode>(index >= 8 ? 0x7A : 0xFA) }, 0x7F, 0x6F, index, offset);
+						break;
+					}
+
+					offset += static_cast<std::uint32_t>(a_width);
+				}
+
+				// each opmask keeps a qword slot
+				for (OpCode k = 0; a_opmask && k < 8; ++k) {
+					if (a_opmask == 0x8) {
+						// kmovq [rsp + disp], k | kmovq k, [rsp + disp]
+						encoder.move({ 0xC4, 0xE1, 0xF8 }, 0x91, 0x90, k, offset);
+					} else {
+						// kmovw [rsp + disp], k | kmovw k, [rsp + disp]
+						encoder.move({ 0xC5, 0xF8 }, 0x91, 0x90, k, offset);
+					}
+					offset += sizeof(std::uint64_t);
+				}
+
+				return encoder.size();
+			}
+
+			/** \brief Size of the prolog of a non volatile patch, epilog is of the same size
+			 * \param a_regs : Register flags
+			 * \param a_simds : SIMD flags
+			 * \return std::size_t : bytes of prolog
+			 */
+			[[nodiscard]] inline constexpr std::size_t nonvolatile_size(
+				const std::uint32_t a_regs,
+				const std::uint32_t a_simds,
+				const std::size_t   a_width = 0x10,
+				const std::size_t   a_opmask = 0x0) noexcept
+			{
+				return encode_nonvolatile(a_regs, a_simds, {}, a_width, a_opmask);
+			}
+
+			// x87, sse, avx, mpx, avx512 and pkru, amx tile data alone would exceed a page of stack
+			constexpr std::uint32_t XSAVE_MASK = 0x2FF;
+
+			/** \brief Encode an extended state patch, state is saved on a 64 byte aligned frame below rbp
+			 * \brief rax and rdx hold the return value of the hook, they are carried over xrstor through the frame
+			 * \param a_mask : State components to save
+			 * \param a_size : Bytes of xsave area
+			 * \param a_compact : Use xsavec instead of xsave
+			 * \param a_buf : Buffer of prolog and epilog size, or empty to only count the sizes
+			 * \return std::pair : bytes of prolog and epilog
+			 */
+			inline constexpr std::pair<std::size_t, std::size_t> encode_xsave(
+				const std::uint32_t a_mask,
+				const std::uint32_t a_size,
+				const bool          a_compact,
+				std::span<OpCode>   a_buf) noexcept
+			{
+				nonvolatile_encoder encoder{ a_buf };
+
+				// epilog is emitted backwards, each pair below ends up in reverse order
+				// push rax | pop rax, push rdx | pop rdx, push rbp | pop rbp
+				encoder.emit({ 0x50 }, { 0x58 });
+				encoder.emit({ 0x52 }, { 0x5A });
+				encoder.emit({ 0x55 }, { 0x5D });
+
+				// mov rbp, rsp | mov rsp, rbp
+				encoder.emit({ 0x48, 0x89, 0xE5 }, { 0x48, 0x89, 0xEC });
+
+				// sub rsp, imm32 | and rsp, -0x40
+				const auto size = imm32(a_size);
+				encoder.emit({ 0x48, 0x81, 0xEC, size[0], size[1], size[2], size[3], 0x48, 0x83, 0xE4, 0xC0 }, {});
+
+				// xor eax, eax | mov [rsp + 0x200 + i * 8], rax, xsave header must be zero
+				encoder.emit({ 0x31, 0xC0 }, {});
+				for (std::uint32_t i = 0; i < 8; ++i) {
+					const auto disp = imm32(0x200 + i * 8);
+					encoder.emit({ 0x48, 0x89, 0x84, 0x24, disp[0], disp[1], disp[2], disp[3] }, {});
+				}
+
+				// mov eax, mask | mov edx, 0 ; xrstor64 [rsp]
+				const auto mask = imm32(a_mask);
+				encoder.emit({ 0xB8, mask[0], mask[1], mask[2], mask[3], 0xBA, 0x00, 0x00, 0x00, 0x00 }, { 0x48, 0x0F, 0xAE, 0x2C, 0x24 });
+
+				// xsavec64 [rsp] or xsave64 [rsp] ; mov eax, mask | mov edx, 0
+				encoder.emit({ 0x48, 0x0F, static_cast<OpCode>(a_compact ? 0xC7 : 0xAE), 0x24, 0x24 }, { 0xB8, mask[0], mask[1], mask[2], mask[3], 0xBA, 0x00, 0x00, 0x00, 0x00 });
+
+				// mov rdx, [rbp + 0x8] | mov rax, [rbp + 0x10] ; mov [rbp + 0x10], rax | mov [rbp + 0x8], rdx
+				encoder.emit({ 0x48, 0x8B, 0x55, 0x08, 0x48, 0x8B, 0x45, 0x10 }, { 0x48, 0x89, 0x45, 0x10, 0x48, 0x89, 0x55, 0x08 });
+
+				return { encoder.size(), encoder.epilog_size() };
+			}
+
+			// full extended state, sized from cpuid on first use
+			[[nodiscard]] inline patch_descriptor xsave_patch() noexcept
+			{
+				static const patch_block block = []() noexcept {
+					dku_assert(CPU::xcr0(),
+						"DKU_H: XSAVE preservation requires os enabled xsave");
+
+					const bool compact = CPU::has_xsavec();
+					const auto mask = static_cast<std::uint32_t>(CPU::xcr0() & XSAVE_MASK);
+					const auto size = CPU::xsave_size(mask, compact);
+
+					// prolog is longer than epilog, epilog is the rest of the block
+					const auto [prolog, epilog] = encode_xsave(mask, size, compact, {});
+
+					patch_block xsave{ std::vector<OpCode>(prolog + epilog, INT3), prolog };
+					encode_xsave(mask, size, compact, xsave.first);
+
+					return xsave;
+				}();
+
+				const auto& [buf, end] = block;
+				return patch_descriptor{
+					{ buf.data(), end },
+					{ buf.data() + end, buf.size() - end }
+				};
+			}
+
+			template <typename Flag>
+			[[nodiscard]] inline consteval std::uint32_t flags_of(const auto... a_flags) noexcept
+			{
+				return ((std::same_as<std::remove_cvref_t<decltype(a_flags)>, Flag> ? std::to_underlying(a_flags) : 0u) | ... | 0u);
+			}
+
+			// prolog and epilog back to back
+			template <std::uint32_t Regs, std::uint32_t Simds, std::size_t Width, std::size_t Opmask>
+			[[nodiscard]] inline consteval auto make_nonvolatile_block() noexcept
+			{
+				std::array<OpCode, nonvolatile_size(Regs, Simds, Width, Opmask) * 2> block{};
+				encode_nonvolatile(Regs, Simds, block, Width, Opmask);
+				return block;
+			}
+
+			template <std::uint32_t Regs, std::uint32_t Simds, std::size_t Width = 0x10, std::size_t Opmask = 0x0>
+			inline constexpr auto nonvolatile_block = make_nonvolatile_block<Regs, Simds, Width, Opmask>();
+
+			template <std::uint32_t Regs, std::uint32_t Simds, std::size_t Width, std::size_t Opmask>
+			[[nodiscard]] inline patch_descriptor view_block() noexcept
+			{
+				constexpr auto& block = nonvolatile_block<Regs, Simds, Width, Opmask>;
+				constexpr auto  size = block.size() / 2;
+
+				return patch_descriptor{
+					{ block.data(), size },
+					{ block.data() + size, size }
+				};
+			}
+
+			// compile time blocks of each width up to the requested one, the widest enabled is used
+			template <std::uint32_t Regs, std::uint32_t Simds, std::uint32_t Avx>
+			[[nodiscard]] inline patch_descriptor select_block() noexcept
+			{
+				constexpr auto width = requested_width(Avx);
+				constexpr bool opmask = Avx & std::to_underlying(AVX::K);
+				static_assert(width == 0x10 || expand_simd(Simds), "AVX::YMM or AVX::ZMM requires SIMD registers to widen");
+
+				if constexpr (width == 0x40 || opmask) {
+					if (CPU::has_avx512bw()) {
+						return view_block<Regs, Simds, width, opmask ? 0x8 : 0x0>();
+					}
+
+					if (CPU::has_avx512()) {
+						return view_block<Regs, Simds, width, opmask ? 0x2 : 0x0>();
 					}
 				}
+
+				if constexpr (width >= 0x20) {
+					if (CPU::has_avx()) {
+						return view_block<Regs, Simds, 0x20, 0x0>();
+					}
+				}
+
+				return view_block<Regs, Simds, 0x10, 0x0>();
+			}
+		}  // namespace detail
+
+		/** \brief Generates non volatile patch at compile time
+		 * \brief push/pop to preserve registers, then vmovdqu/kmovq to preserve SIMD registers and opmasks, or xsave for full state
+		 * \param <Flags> : Register, SIMD and AVX values to preserve, e.g. <Register::RBX, SIMD::XMM0, AVX::YMM>
+		 * \return patch_descriptor : a pair of views of prolog and epilog of this patch
+		 */
+		template <auto... Flags>
+			requires((std::same_as<decltype(Flags), Register> || std::same_as<decltype(Flags), SIMD> || std::same_as<decltype(Flags), AVX>) && ...)
+		[[nodiscard]] inline patch_descriptor MakeNonVolatilePatch() noexcept
+		{
+			constexpr auto regs = detail::flags_of<Register>(Flags...);
+			constexpr auto simds = detail::flags_of<SIMD>(Flags...);
+			constexpr auto avx = detail::flags_of<AVX>(Flags...) & ~std::to_underlying(AVX::NONE);
+
+			if constexpr (avx & std::to_underlying(AVX::XSAVE)) {
+				if constexpr (!detail::expand(regs)) {
+					return detail::xsave_patch();
+				} else {
+					auto [prolog, epilog] = detail::view_block<regs, 0, 0x10, 0x0>();
+					auto [xprolog, xepilog] = detail::xsave_patch();
+					prolog.Append(xprolog);
+					xepilog.Append(epilog);
+
+					return patch_descriptor{ std::move(prolog), std::move(xepilog) };
+				}
+			} else {
+				return detail::select_block<regs, simds, avx>();
+			}
+		}
+
+		/** \brief Allocates a block of memory and generates non volatile patch
+		 * \brief push/pop to preserve registers
+		 * \param a_regs : { reg1, reg2, reg3... } registers to preserve
+		 * \return patch_descriptor : a pair of views of prolog and epilog of this patch
+		 */
+		inline patch_descriptor MakeNonVolatilePatch(enumeration<Register> a_regs)
+		{
+			static std::unordered_map<Register, patch_block> Patches;
+			static std::mutex                                Lock;
+
+			if (a_regs.any(Register::NONE)) {
+				return {};
+			}
+
+			std::unique_lock guard{ Lock };
+
+			auto& [buf, end] = Patches[a_regs.get()];
+			if (buf.empty()) {
+				end = detail::nonvolatile_size(a_regs.underlying(), 0);
+				buf.resize(end * 2, INT3);
+				detail::encode_nonvolatile(a_regs.underlying(), 0, buf);
 			}
 
 			return patch_descriptor{
 				{ buf.data(), end },
-				{ buf.data() + buf.size() - end, end }
+				{ buf.data() + end, end }
 			};
 		}
 
 		/** \brief Allocates a block of memory and generates non volatile patch
-		 * \brief push/pop to preserve SSE registers
-		 * \param a_regs : { simd1, simd2, simd3... } registers to preserve
+		 * \brief vmovdqu/kmovq to preserve SIMD registers and opmasks, or xsave for full state
+		 * \param a_simds : { simd1, simd2, simd3... } registers to preserve
+		 * \param a_avx : { AVX::YMM, AVX::K... } width and extra state to preserve
 		 * \return patch_descriptor : a pair of views of prolog and epilog of this patch
 		 */
-		inline patch_descriptor MakeNonVolatilePatch(enumeration<SIMD> a_simds)
+		inline patch_descriptor MakeNonVolatilePatch(enumeration<SIMD> a_simds, enumeration<AVX> a_avx = { AVX::NONE })
 		{
-			static std::unordered_map<SIMD, patch_block> Patches;
+			static std::unordered_map<std::uint64_t, patch_block> Patches;
+			static std::mutex                                     Lock;
 
-			if (a_simds.any(SIMD::NONE)) {
-				return {};
+			if (a_avx.any(AVX::XSAVE)) {
+				return detail::xsave_patch();
 			}
 
-			auto& [buf, end] = Patches[a_simds.get()];
+			const auto simds = detail::expand_simd(a_simds.underlying());
+			dku_assert(simds || a_avx.none(AVX::YMM, AVX::ZMM),
+				"DKU_H: AVX::YMM or AVX::ZMM requires SIMD registers to widen");
 
-			if (buf.empty() || !end) {
-				// size
-				std::size_t bufSize{ sizeof(SubRspEx) };
-#if defined(DKU_H_JIT_MAX_SIZE_BUFFER)
-				constexpr auto Block = std::bit_width(std::to_underlying(SIMD::ALL)) * sizeof(MovDquRsp);
-				bufSize += Block * 2;
-#else
-				auto count = 0;
-				for (auto simd : a_simds.flag_range(SIMD::XMM0, SIMD::XMM15)) {
-					if (a_simds.any(simd, SIMD::ALL)) {
-						count++;
-						bufSize += sizeof(MovDquRsp);
-					}
-				}
+			const auto width = detail::vector_width(a_avx.underlying());
+			const auto opmask = a_avx.any(AVX::K) ? detail::opmask_width() : 0x0;
+			if (!simds && !opmask) {
+				return {};
+			}
 
-				bufSize += count >= 8 ? count * 0x4 : count;
-				bufSize *= 2;
-#endif
-				buf.resize(bufSize, INT3);
-				end = sizeof(SubRspEx);
-
-				// prefix in
-				Disp32 stackSize{ 0 };
-				for (auto simd : a_simds.flag_range(SIMD::XMM0, SIMD::XMM15)) {
-					if (a_simds.any(simd, SIMD::ALL)) {
-						auto push = MovDquRsp(simd);
-						auto pop = MovDquRsp(simd).ReverseOperand();
-
-						if (stackSize) {
-							if (stackSize < 0x80) {
-								AsMemCpy(buf.data() + end, push);
-								end += sizeof(push);
-								buf[end++] = static_cast<Disp8>(stackSize);
-
-								AsMemCpy(buf.data() + buf.size() - end, pop);
-								buf[buf.size() - end + sizeof(pop)] = static_cast<Disp8>(stackSize);
-							} else {
-								AsMemCpy(buf.data() + end, push.ExtendedRange());
-								end += sizeof(push);
-								AsMemCpy(buf.data() + end, stackSize);
-								end += sizeof(stackSize);
-
-								AsMemCpy(buf.data() + buf.size() - end, pop.ExtendedRange());
-								AsMemCpy(buf.data() + buf.size() - end + sizeof(pop), stackSize);
-							}
-						} else {
-							AsMemCpy(buf.data() + end, push.NoSibAddress());
-							end += sizeof(push);
-							AsMemCpy(buf.data() + buf.size() - end, pop.NoSibAddress());
-						}
-
-						// reserve
-						stackSize += 0x10;
-					}
-				}
+			std::unique_lock guard{ Lock };
 
-				// alloc
-				AsMemCpy(buf.data(), SubRspEx(stackSize));
-				AsMemCpy(buf.data() + buf.size() - sizeof(SubRspEx), AddRspEx(stackSize));
+			auto& [buf, end] = Patches[simds | static_cast<std::uint64_t>(width | opmask) << 32];
+			if (buf.empty()) {
+				end = detail::nonvolatile_size(0, simds, width, opmask);
+				buf.resize(end * 2, INT3);
+				detail::encode_nonvolatile(0, simds, buf, width, opmask);
 			}
 
 			return patch_descriptor{
 				{ buf.data(), end },
-				{ buf.data() + buf.size() - end, end }
+				{ buf.data() + end, end }
 			};
 		}
 	}  // namespace JIT
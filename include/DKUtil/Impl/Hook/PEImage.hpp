@@ -0,0 +1,343 @@
+#pragma once
+
+#include "Assembly.hpp"
+
+namespace DKUtil::Hook
+{
+	namespace detail::pe
+	{
+		// on-disk pe32+ layouts, declared here so images can be read without windows headers
+		struct DosHeader
+		{
+			std::uint16_t magic;
+			std::uint8_t  reserved[58];
+			std::int32_t  lfanew;
+		};
+		static_assert(sizeof(DosHeader) == 0x40);
+
+		struct FileHeader
+		{
+			std::uint16_t machine;
+			std::uint16_t numberOfSections;
+			std::uint32_t timeDateStamp;
+			std::uint32_t pointerToSymbolTable;
+			std::uint32_t numberOfSymbols;
+			std::uint16_t sizeOfOptionalHeader;
+			std::uint16_t characteristics;
+		};
+		static_assert(sizeof(FileHeader) == 0x14);
+
+		struct DataDirectory
+		{
+			std::uint32_t virtualAddress;
+			std::uint32_t size;
+		};
+
+		struct OptionalHeader64
+		{
+			std::uint16_t magic;
+			std::uint8_t  majorLinkerVersion;
+			std::uint8_t  minorLinkerVersion;
+			std::uint32_t sizeOfCode;
+			std::uint32_t sizeOfInitializedData;
+			std::uint32_t sizeOfUninitializedData;
+			std::uint32_t addressOfEntryPoint;
+			std::uint32_t baseOfCode;
+			std::uint64_t imageBase;
+			std::uint32_t sectionAlignment;
+			std::uint32_t fileAlignment;
+			std::uint16_t majorOperatingSystemVersion;
+			std::uint16_t minorOperatingSystemVersion;
+			std::uint16_t majorImageVersion;
+			std::uint16_t minorImageVersion;
+			std::uint16_t majorSubsystemVersion;
+			std::uint16_t minorSubsystemVersion;
+			std::uint32_t win32VersionValue;
+			std::uint32_t sizeOfImage;
+			std::uint32_t sizeOfHeaders;
+			std::uint32_t checkSum;
+			std::uint16_t subsystem;
+			std::uint16_t dllCharacteristics;
+			std::uint64_t sizeOfStackReserve;
+			std::uint64_t sizeOfStackCommit;
+			std::uint64_t sizeOfHeapReserve;
+			std::uint64_t sizeOfHeapCommit;
+			std::uint32_t loaderFlags;
+			std::uint32_t numberOfRvaAndSizes;
+			DataDirectory dataDirectory[16];
+		};
+		static_assert(sizeof(OptionalHeader64) == 0xF0);
+
+		struct NtHeaders64
+		{
+			std::uint32_t    signature;
+			FileHeader       fileHeader;
+			OptionalHeader64 optionalHeader;
+		};
+		static_assert(sizeof(NtHeaders64) == 0x108);
+
+		struct SectionHeader
+		{
+			char          name[8];
+			std::uint32_t virtualSize;
+			std::uint32_t virtualAddress;
+			std::uint32_t sizeOfRawData;
+			std::uint32_t pointerToRawData;
+			std::uint32_t pointerToRelocations;
+			std::uint32_t pointerToLinenumbers;
+			std::uint16_t numberOfRelocations;
+			std::uint16_t numberOfLinenumbers;
+			std::uint32_t characteristics;
+		};
+		static_assert(sizeof(SectionHeader) == 0x28);
+
+		struct ImportDescriptor
+		{
+			std::uint32_t originalFirstThunk;
+			std::uint32_t timeDateStamp;
+			std::uint32_t forwarderChain;
+			std::uint32_t name;
+			std::uint32_t firstThunk;
+		};
+		static_assert(sizeof(ImportDescriptor) == 0x14);
+
+		inline constexpr std::uint16_t DOS_MAGIC = 0x5A4D;
+		inline constexpr std::uint32_t NT_SIGNATURE = 0x00004550;
+		inline constexpr std::uint16_t PE32PLUS_MAGIC = 0x020B;
+		inline constexpr std::size_t   IMPORT_DIRECTORY = 1;
+		inline constexpr std::uint64_t ORDINAL_FLAG = 1ull << 63;
+	}  // namespace detail::pe
+
+	/** \brief Executable image mapped from disk, queried without loading it.
+	 * \brief Sections are located through their raw file data, addresses returned by section and search_pattern
+	 * \brief point into the read only file view. Use rva to translate them into relative virtual addresses,
+	 * \brief which are the same in the loaded module, i.e. Module::base() + rva.
+	 */
+	class PEImage
+	{
+	public:
+		using Section = Module::Section;
+
+		explicit PEImage(const std::filesystem::path& a_path) :
+			_file(Platform::map_file(a_path))
+		{
+			dku_assert(_file.data, "DKU_H: Failed to map image {}\nerror : {}", a_path.string(), Platform::last_error());
+
+			const auto* dosHeader = header<detail::pe::DosHeader>(0);
+			dku_assert(dosHeader && dosHeader->magic == detail::pe::DOS_MAGIC,
+				"DKU_H: {} is not a pe image", a_path.string());
+
+			dku_assert(dosHeader->lfanew >= 0,
+				"DKU_H: {} has a negative nt header offset", a_path.string());
+
+			_ntHeader = header<detail::pe::NtHeaders64>(dosHeader->lfanew);
+			dku_assert(_ntHeader && _ntHeader->signature == detail::pe::NT_SIGNATURE && _ntHeader->optionalHeader.magic == detail::pe::PE32PLUS_MAGIC,
+				"DKU_H: {} is not a pe32+ image", a_path.string());
+
+			const auto sectionOffset = static_cast<std::size_t>(dosHeader->lfanew) + offsetof(detail::pe::NtHeaders64, optionalHeader) + _ntHeader->fileHeader.sizeOfOptionalHeader;
+			const auto sectionCount = _ntHeader->fileHeader.numberOfSections;
+			dku_assert(fits(sectionOffset, sectionCount * sizeof(detail::pe::SectionHeader)),
+				"DKU_H: {} has truncated section headers", a_path.string());
+
+			_sectionHeaders = { header<detail::pe::SectionHeader>(sectionOffset), sectionCount };
+
+			// same naming rule as Module, first matching section is kept
+			for (const auto& section : _sectionHeaders) {
+				// truncated images keep only the raw data that is actually in the file
+				const auto rawSize = fits(section.pointerToRawData, section.sizeOfRawData) ?
+				                         section.sizeOfRawData :
+				                         static_cast<std::uint32_t>(section.pointerToRawData < _file.size ? _file.size - section.pointerToRawData : 0);
+				if (rawSize != section.sizeOfRawData) {
+					__WARN("DKU_H: {} section {} raw data exceeds file, trimmed to {:X}",
+						a_path.string(), std::string_view(section.name, strnlen(section.name, sizeof(section.name))), rawSize);
+				}
+
+				auto& sectionNameTbl = dku::static_enum<Section>();
+				for (Section name : sectionNameTbl.value_range(Section::textx, Section::gfids)) {
+					const auto len = (std::min)(dku::print_enum(name).size(), std::extent_v<decltype(section.name)>);
+					auto&      descriptor = _sections[std::to_underlying(name)];
+					if (!std::get<1>(descriptor) && std::memcmp(dku::print_enum(name).data(), section.name + 1, len - 1) == 0) {
+						descriptor = std::make_tuple(section.virtualAddress, (std::min)(section.virtualSize, rawSize));
+					}
+				}
+			}
+		}
+
+		~PEImage() noexcept
+		{
+			Platform::unmap_file(_file);
+		}
+
+		PEImage(const PEImage&) = delete;
+		PEImage& operator=(const PEImage&) = delete;
+
+		[[nodiscard]] constexpr auto* data() const noexcept { return _file.data; }
+		[[nodiscard]] constexpr auto  size() const noexcept { return _file.size; }
+		[[nodiscard]] constexpr auto* ntHeader() const noexcept { return _ntHeader; }
+		[[nodiscard]] constexpr auto  sectionHeaders() const noexcept { return _sectionHeaders; }
+		[[nodiscard]] constexpr auto  imageBase() const noexcept { return _ntHeader->optionalHeader.imageBase; }
+		[[nodiscard]] constexpr auto  timestamp() const noexcept { return _ntHeader->fileHeader.timeDateStamp; }
+
+		/** \brief Translate a relative virtual address to a file offset.
+		 * \return std::optional<std::size_t> : std::nullopt if the rva has no file data, e.g. uninitialized section tail.
+		 */
+		[[nodiscard]] std::optional<std::size_t> offset(std::uint32_t a_rva) const noexcept
+		{
+			if (a_rva < _ntHeader->optionalHeader.sizeOfHeaders) {
+				return a_rva < _file.size ? std::make_optional<std::size_t>(a_rva) : std::nullopt;
+			}
+
+			for (const auto& section : _sectionHeaders) {
+				if (a_rva < section.virtualAddress || a_rva - section.virtualAddress >= section.sizeOfRawData) {
+					continue;
+				}
+
+				const auto offset = static_cast<std::size_t>(section.pointerToRawData) + (a_rva - section.virtualAddress);
+				return offset < _file.size ? std::make_optional(offset) : std::nullopt;
+			}
+
+			return std::nullopt;
+		}
+
+		/** \brief Translate a pointer into the file view back to a relative virtual address.
+		 * \return std::uint32_t : 0 if the pointer is not within any section or the headers.
+		 */
+		[[nodiscard]] std::uint32_t rva(const void* a_ptr) const noexcept
+		{
+			const auto address = AsAddress(a_ptr);
+			const auto begin = AsAddress(_file.data);
+			if (address < begin || address >= begin + _file.size) {
+				return 0;
+			}
+
+			const auto offset = address - begin;
+			if (offset < _ntHeader->optionalHeader.sizeOfHeaders) {
+				return static_cast<std::uint32_t>(offset);
+			}
+
+			for (const auto& section : _sectionHeaders) {
+				if (offset >= section.pointerToRawData && offset - section.pointerToRawData < section.sizeOfRawData) {
+					return static_cast<std::uint32_t>(section.virtualAddress + (offset - section.pointerToRawData));
+				}
+			}
+
+			return 0;
+		}
+
+		// pointer into file view, nullptr if the rva has no file data
+		template <typename T = std::byte>
+		[[nodiscard]] const T* at(std::uint32_t a_rva) const noexcept
+		{
+			const auto off = offset(a_rva);
+			return off && fits(*off, sizeof(T)) ? std::bit_cast<const T*>(_file.data + *off) : nullptr;
+		}
+
+		/** \brief Section data in file view.
+		 * \return std::pair<std::uintptr_t, std::size_t> : address in file view and size of raw data within the file, {0, 0} if absent.
+		 */
+		[[nodiscard]] std::pair<std::uintptr_t, std::size_t> section(Section a_section) const noexcept
+		{
+			const auto& [rva, size] = _sections[std::to_underlying(a_section)];
+			const auto  off = rva && size ? offset(rva) : std::nullopt;
+			if (!off) {
+				return { 0, 0 };
+			}
+
+			return { AsAddress(_file.data + *off), (std::min)(static_cast<std::size_t>(size), _file.size - *off) };
+		}
+
+		// relative virtual address and size of section, as it is loaded
+		[[nodiscard]] constexpr std::pair<std::uint32_t, std::size_t> section_rva(Section a_section) const noexcept
+		{
+			const auto& [rva, size] = _sections[std::to_underlying(a_section)];
+			return { rva, size };
+		}
+
+		/** \brief Search for a pattern in a section of the image.
+		 * \param a_pattern : hex string pattern, same syntax as Assembly::search_pattern.
+		 * \return std::byte* : match in read only file view, nullptr if none found. Use rva to translate.
+		 */
+		[[nodiscard]] std::byte* search_pattern(std::string_view a_pattern, Section a_section = Section::textx) const
+		{
+			const auto [data, size] = section(a_section);
+			if (!data) {
+				return nullptr;
+			}
+
+			return Assembly::search_pattern(a_pattern, data, size);
+		}
+
+		/** \brief Get the import address table entry of an imported function.
+		 * \return std::uint32_t : relative virtual address of the entry, 0 if not imported by name.
+		 */
+		[[nodiscard]] std::uint32_t GetImportAddress(std::string_view a_libraryName, std::string_view a_importName) const noexcept
+		{
+			const auto& directory = _ntHeader->optionalHeader.dataDirectory[detail::pe::IMPORT_DIRECTORY];
+			if (_ntHeader->optionalHeader.numberOfRvaAndSizes <= detail::pe::IMPORT_DIRECTORY || !directory.virtualAddress) {
+				return 0;
+			}
+
+			for (auto rva = directory.virtualAddress;; rva += sizeof(detail::pe::ImportDescriptor)) {
+				const auto* importTbl = at<detail::pe::ImportDescriptor>(rva);
+				if (!importTbl || !importTbl->name) {
+					break;
+				}
+
+				const auto* libraryName = c_str(importTbl->name);
+				if (!libraryName || !string::iequals(a_libraryName, libraryName)) {
+					continue;
+				}
+
+				// bound images may overwrite FirstThunk on disk, names are read from OriginalFirstThunk when present
+				const auto lookup = importTbl->originalFirstThunk ? importTbl->originalFirstThunk : importTbl->firstThunk;
+				for (std::uint32_t idx = 0;; ++idx) {
+					const auto* thunk = at<std::uint64_t>(lookup + idx * sizeof(std::uint64_t));
+					if (!thunk || !*thunk) {
+						break;
+					}
+
+					if (*thunk & detail::pe::ORDINAL_FLAG) {
+						continue;
+					}
+
+					// IMAGE_IMPORT_BY_NAME, 2 byte hint precedes the name
+					const auto* name = c_str(static_cast<std::uint32_t>(*thunk) + sizeof(std::uint16_t));
+					if (name && string::iequals(a_importName, name)) {
+						return importTbl->firstThunk + idx * static_cast<std::uint32_t>(sizeof(std::uint64_t));
+					}
+				}
+			}
+
+			return 0;
+		}
+
+	private:
+		// a_size bytes at a_offset are within file data, without overflowing the sum
+		[[nodiscard]] constexpr bool fits(std::size_t a_offset, std::size_t a_size) const noexcept
+		{
+			return a_offset <= _file.size && a_size <= _file.size - a_offset;
+		}
+
+		template <typename T>
+		[[nodiscard]] const T* header(std::size_t a_offset) const noexcept
+		{
+			return fits(a_offset, sizeof(T)) ? std::bit_cast<const T*>(_file.data + a_offset) : nullptr;
+		}
+
+		// null terminated string within file data
+		[[nodiscard]] const char* c_str(std::uint32_t a_rva) const noexcept
+		{
+			const auto off = offset(a_rva);
+			if (!off || !std::memchr(_file.data + *off, 0, _file.size - *off)) {
+				return nullptr;
+			}
+
+			return std::bit_cast<const char*>(_file.data + *off);
+		}
+
+		Platform::MappedFile                                                                     _file;
+		const detail::pe::NtHeaders64*                                                           _ntHeader{ nullptr };
+		std::span<const detail::pe::SectionHeader>                                               _sectionHeaders;
+		std::array<std::tuple<std::uint32_t, std::uint32_t>, std::to_underlying(Section::total)> _sections{};
+	};
+}  // namespace DKUtil::Hook
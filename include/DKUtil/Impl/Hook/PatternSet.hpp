@@ -0,0 +1,203 @@
+#pragma once
+
+#include "Assembly.hpp"
+
+namespace DKUtil::Hook::Assembly
+{
+	/** \brief Resolves many byte patterns in a single pass over memory.
+	 * \brief Each pattern is bucketed by its rarest pair of adjacent literal bytes, or by its rarest literal byte
+	 * \brief when no such pair exists. The scan streams through memory once, a bitmap rejects most positions
+	 * \brief before any bucket lookup, candidates are then verified with the compiled value/mask vectors.
+	 */
+	class PatternSet
+	{
+	public:
+		using pattern_id = std::size_t;
+		using match_table = std::vector<std::byte*>;
+
+		PatternSet() = default;
+		PatternSet(std::initializer_list<std::string_view> a_patterns)
+		{
+			for (auto pattern : a_patterns) {
+				add(pattern);
+			}
+		}
+
+		/** \brief Add a hex string pattern to the set, same syntax as search_pattern.
+		 * \return pattern_id : index of this pattern in the match table.
+		 */
+		pattern_id add(std::string_view a_pattern)
+		{
+			const auto bytes = Pattern::make_byte_matches(Pattern::sanitize(a_pattern));
+			dku_assert(!bytes.empty(), "DKU_H: PatternSet cannot add an empty pattern");
+
+			const pattern_id id = _patterns.size();
+			auto&            pattern = _patterns.emplace_back(Pattern::compile(bytes));
+
+			// rarest adjacent literal pair
+			std::size_t   pair = 0;
+			std::uint32_t pairRank = std::numeric_limits<std::uint32_t>::max();
+			for (std::size_t i = 0; i + 1 < bytes.size(); ++i) {
+				if (bytes[i].wildcard || bytes[i + 1].wildcard) {
+					continue;
+				}
+
+				const std::uint32_t rank = Pattern::byte_rank(bytes[i].hex) + Pattern::byte_rank(bytes[i + 1].hex);
+				if (rank < pairRank) {
+					pair = i;
+					pairRank = rank;
+				}
+			}
+
+			if (pairRank != std::numeric_limits<std::uint32_t>::max()) {
+				const auto key = static_cast<std::uint16_t>(std::to_integer<std::uint16_t>(bytes[pair].hex) | std::to_integer<std::uint16_t>(bytes[pair + 1].hex) << 8);
+				_pending.emplace_back(key, Entry{ id, pair });
+			} else {
+				const auto key = std::to_integer<std::uint8_t>(pattern.value[pattern.anchor]);
+				_single[key].emplace_back(id, pattern.anchor);
+				_singleMap[key >> 6] |= 1ull << (key & 63);
+			}
+
+			_dirty = true;
+			return id;
+		}
+
+		/** \brief Resolve all patterns in one pass.
+		 * \param a_base : base address of memory block to search, default to module textx section.
+		 * \param a_size : size of memory block to search, default to module textx size.
+		 * \return match_table : first match of each pattern indexed by pattern_id, nullptr if not found.
+		 */
+		[[nodiscard]] match_table search(model::concepts::dku_memory auto a_base = 0, std::size_t a_size = 0)
+		{
+			std::uintptr_t base{ AsAddress(a_base) };
+
+			auto [textx, size] = Module::get().section(Module::Section::textx);
+
+			if (!base) {
+				base = textx;
+			}
+
+			if (!a_size) {
+				a_size = size;
+			}
+
+			build();
+
+			const auto* begin = static_cast<const std::byte*>(AsPointer(base));
+			const auto* end = begin + a_size;
+
+			match_table matches(_patterns.size(), nullptr);
+			std::size_t unresolved = _patterns.size();
+
+			auto try_entry = [&](const Entry& a_entry, const std::byte* a_mem) {
+				if (matches[a_entry.id]) {
+					return;
+				}
+
+				const auto& pattern = _patterns[a_entry.id];
+				if (a_mem - begin < static_cast<std::ptrdiff_t>(a_entry.offset)) {
+					return;
+				}
+
+				const auto* candidate = a_mem - a_entry.offset;
+				if (end - candidate < static_cast<std::ptrdiff_t>(pattern.size)) {
+					return;
+				}
+
+				if (Pattern::detail::verify_sse2(candidate, end, pattern)) {
+					matches[a_entry.id] = const_cast<std::byte*>(candidate);
+					--unresolved;
+				}
+			};
+
+			for (const auto* mem = begin; mem < end && unresolved; ++mem) {
+				const auto lo = std::to_integer<std::uint8_t>(mem[0]);
+
+				if (_singleMap[lo >> 6] & (1ull << (lo & 63))) {
+					for (const auto& entry : _single[lo]) {
+						try_entry(entry, mem);
+					}
+				}
+
+				if (mem + 1 == end) {
+					break;
+				}
+
+				const auto key = static_cast<std::uint16_t>(lo | std::to_integer<std::uint16_t>(mem[1]) << 8);
+				if (_pairMap[key >> 6] & (1ull << (key & 63))) {
+					for (auto i = _pairIndex[key]; i < _pairIndex[key + 1]; ++i) {
+						try_entry(_pairs[i], mem);
+					}
+				}
+			}
+
+			return matches;
+		}
+
+		[[nodiscard]] constexpr std::size_t size() const noexcept { return _patterns.size(); }
+		[[nodiscard]] constexpr bool        empty() const noexcept { return _patterns.empty(); }
+
+	private:
+		struct Entry
+		{
+			pattern_id  id;
+			std::size_t offset;
+		};
+
+		static constexpr std::size_t PAIRS = static_cast<std::size_t>(1) << 16;
+
+		// flatten pending pairs into a bucketed index
+		void build()
+		{
+			if (!_dirty) {
+				return;
+			}
+
+			_pairIndex.assign(PAIRS + 1, 0);
+			_pairMap.assign(PAIRS / 64, 0);
+			_pairs.resize(_pending.size());
+
+			for (const auto& [key, entry] : _pending) {
+				++_pairIndex[key + 1];
+				_pairMap[key >> 6] |= 1ull << (key & 63);
+			}
+
+			std::partial_sum(_pairIndex.begin(), _pairIndex.end(), _pairIndex.begin());
+
+			auto cursor = _pairIndex;
+			for (const auto& [key, entry] : _pending) {
+				_pairs[cursor[key]++] = entry;
+			}
+
+			_dirty = false;
+		}
+
+		std::vector<Pattern::CompiledPattern>        _patterns;
+		std::vector<std::pair<std::uint16_t, Entry>> _pending;
+		std::vector<Entry>                           _pairs;
+		std::vector<std::uint32_t>                   _pairIndex;
+		std::vector<std::uint64_t>                   _pairMap;
+		std::array<std::vector<Entry>, 0x100>        _single{};
+		std::array<std::uint64_t, 0x100 / 64>        _singleMap{};
+		bool                                         _dirty{ false };
+	};
+
+	/** \brief Search many byte patterns in memory with a single pass.
+	 * \param a_patterns : hex string patterns, same syntax as search_pattern.
+	 * \param a_base : base address of memory block to search, default to module textx section.
+	 * \param a_size : size of memory block to search, default to module textx size.
+	 * \return match table : first match of each pattern in the given order, nullptr if not found.
+	 */
+	[[nodiscard]] inline auto search_patterns(
+		std::span<const std::string_view> a_patterns,
+		model::concepts::dku_memory auto  a_base = 0,
+		std::size_t                       a_size = 0)
+	{
+		PatternSet set;
+		for (auto pattern : a_patterns) {
+			set.add(pattern);
+		}
+
+		return set.search(a_base, a_size);
+	}
+}  // namespace DKUtil::Hook::Assembly
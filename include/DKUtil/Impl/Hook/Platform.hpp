@@ -0,0 +1,646 @@
+#pragma once
+
+#if defined(_WIN32)
+#	include <TlHelp32.h>
+#else
+#	include <dirent.h>
+#	include <dlfcn.h>
+#	include <fcntl.h>
+#	include <link.h>
+#	include <signal.h>
+#	include <sys/stat.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <ucontext.h>
+#	include <unistd.h>
+#endif
+
+// operating system primitives used by module, patching and trampoline, win32 or posix/elf
+namespace DKUtil::Hook::Platform
+{
+#if defined(_WIN32)
+	using module_handle = ::HMODULE;
+	using process_id = ::DWORD;
+	using thread_id = ::DWORD;
+	using protection = ::DWORD;
+
+	inline constexpr protection EXECUTE_READWRITE = PAGE_EXECUTE_READWRITE;
+#else
+	using module_handle = void*;
+	using process_id = ::pid_t;
+	using thread_id = ::pid_t;
+	using protection = int;
+
+	inline constexpr protection EXECUTE_READWRITE = PROT_READ | PROT_WRITE | PROT_EXEC;
+#endif
+
+	struct MemoryRegion
+	{
+		std::uintptr_t base{ 0 };
+		std::size_t    size{ 0 };
+		protection     protect{ 0 };
+		bool           free{ true };
+	};
+
+	[[nodiscard]] inline std::size_t page_size() noexcept
+	{
+		static const std::size_t size = [] {
+#if defined(_WIN32)
+			::SYSTEM_INFO si;
+			::GetSystemInfo(&si);
+			return static_cast<std::size_t>(si.dwPageSize);
+#else
+			return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+		}();
+
+		return size;
+	}
+
+	[[nodiscard]] inline std::uint32_t last_error() noexcept
+	{
+#if defined(_WIN32)
+		return ::GetLastError();
+#else
+		return static_cast<std::uint32_t>(errno);
+#endif
+	}
+
+#if !defined(_WIN32)
+	namespace detail
+	{
+		// parsed /proc/self/maps, mapped regions in ascending order, gaps between them are free
+		struct RegionCache
+		{
+			std::mutex                lock;
+			std::vector<MemoryRegion> mapped;
+			bool                      valid{ false };
+		};
+
+		[[nodiscard]] inline RegionCache& region_cache() noexcept
+		{
+			static RegionCache cache;
+			return cache;
+		}
+
+		[[nodiscard]] inline bool read_maps(std::vector<MemoryRegion>& a_mapped) noexcept
+		{
+			std::ifstream maps{ "/proc/self/maps" };
+			if (!maps.is_open()) {
+				return false;
+			}
+
+			a_mapped.clear();
+
+			std::string line;
+			while (std::getline(maps, line)) {
+				std::uintptr_t begin{ 0 };
+				std::uintptr_t end{ 0 };
+				char           perms[5]{};
+				if (std::sscanf(line.c_str(), "%" SCNxPTR "-%" SCNxPTR " %4s", &begin, &end, perms) != 3) {
+					continue;
+				}
+
+				const auto protect = (perms[0] == 'r' ? PROT_READ : 0) | (perms[1] == 'w' ? PROT_WRITE : 0) | (perms[2] == 'x' ? PROT_EXEC : 0);
+				a_mapped.emplace_back(begin, end - begin, protect, false);
+			}
+
+			return true;
+		}
+
+		[[nodiscard]] inline MemoryRegion lookup(const std::vector<MemoryRegion>& a_mapped, std::uintptr_t a_address) noexcept
+		{
+			constexpr std::uintptr_t maxAddr = std::numeric_limits<std::uintptr_t>::max();
+
+			const auto next = std::ranges::upper_bound(a_mapped, a_address, {}, &MemoryRegion::base);
+			if (next != a_mapped.begin() && a_address - std::prev(next)->base < std::prev(next)->size) {
+				return *std::prev(next);
+			}
+
+			const auto base = next != a_mapped.begin() ? std::prev(next)->base + std::prev(next)->size : 0;
+			const auto end = next != a_mapped.end() ? next->base : maxAddr;
+			return { base, end - base, 0, true };
+		}
+
+		// mincore fails with ENOMEM on unmapped pages, one syscall tells a stale cached region apart
+		[[nodiscard]] inline bool is_mapped(std::uintptr_t a_address) noexcept
+		{
+			unsigned char resident;
+			return ::mincore(std::bit_cast<void*>(numbers::rounddown(a_address, page_size())), 1, &resident) == 0 || errno != ENOMEM;
+		}
+
+		// keep the cache in step with an mprotect of whole pages, regions are split at the range ends
+		inline void reprotect(std::uintptr_t a_begin, std::uintptr_t a_end, protection a_protect, bool a_success) noexcept
+		{
+			auto&            cache = region_cache();
+			std::unique_lock guard{ cache.lock };
+
+			if (!a_success || !cache.valid) {
+				cache.valid = false;
+				return;
+			}
+
+			std::vector<MemoryRegion> mapped;
+			mapped.reserve(cache.mapped.size() + 2);
+			for (const auto& region : cache.mapped) {
+				const auto end = region.base + region.size;
+				if (end <= a_begin || region.base >= a_end) {
+					mapped.push_back(region);
+					continue;
+				}
+
+				const auto lo = (std::max)(region.base, a_begin);
+				const auto hi = (std::min)(end, a_end);
+				if (region.base < lo) {
+					mapped.emplace_back(region.base, lo - region.base, region.protect, false);
+				}
+				mapped.emplace_back(lo, hi - lo, a_protect, false);
+				if (hi < end) {
+					mapped.emplace_back(hi, end - hi, region.protect, false);
+				}
+			}
+
+			cache.mapped = std::move(mapped);
+		}
+	}  // namespace detail
+#endif
+
+	/** \brief Query the memory region that contains an address.
+	 * \brief On Linux the parsed /proc/self/maps is cached. Memory mapped or reprotected by DKUtil is seen at once, memory
+	 * \brief mapped or unmapped elsewhere is seen on the next query of it. Protection changed elsewhere is seen after the
+	 * \brief next reread, call invalidate_regions to force one.
+	 * \param a_address : address to query.
+	 * \return MemoryRegion : unmapped memory is a free region spanning to the next mapping, size is 0 on failure.
+	 */
+	[[nodiscard]] inline MemoryRegion query(std::uintptr_t a_address) noexcept
+	{
+#if defined(_WIN32)
+		::MEMORY_BASIC_INFORMATION mbi;
+		if (!::VirtualQuery(std::bit_cast<void*>(a_address), &mbi, sizeof(mbi))) {
+			return {};
+		}
+
+		return { std::bit_cast<std::uintptr_t>(mbi.BaseAddress), mbi.RegionSize, mbi.Protect, mbi.State == MEM_FREE };
+#else
+		auto&            cache = detail::region_cache();
+		std::unique_lock guard{ cache.lock };
+
+		if (cache.valid) {
+			if (const auto region = detail::lookup(cache.mapped, a_address); region.free != detail::is_mapped(a_address)) {
+				return region;
+			}
+		}
+
+		cache.valid = detail::read_maps(cache.mapped);
+		return cache.valid ? detail::lookup(cache.mapped, a_address) : MemoryRegion{};
+#endif
+	}
+
+	// drop the cached memory map after mapping or unmapping memory, the next query rereads it
+	inline void invalidate_regions() noexcept
+	{
+#if !defined(_WIN32)
+		auto&            cache = detail::region_cache();
+		std::unique_lock guard{ cache.lock };
+		cache.valid = false;
+#endif
+	}
+
+	[[nodiscard]] constexpr bool executable(protection a_protect) noexcept
+	{
+#if defined(_WIN32)
+		return a_protect & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY);
+#else
+		return a_protect & PROT_EXEC;
+#endif
+	}
+
+	/** \brief Change the protection of every page spanned by a range.
+	 * \param a_old : receives the protection of the first page before the change.
+	 * \return bool : false on failure, see last_error.
+	 */
+	inline bool protect(std::uintptr_t a_address, std::size_t a_size, protection a_protect, protection* a_old = nullptr) noexcept
+	{
+#if defined(_WIN32)
+		protection old{ 0 };
+		const auto success = ::VirtualProtect(std::bit_cast<void*>(a_address), a_size, a_protect, std::addressof(old)) != FALSE;
+#else
+		const auto old = query(a_address).protect;
+		const auto begin = numbers::rounddown(a_address, page_size());
+		const auto end = numbers::roundup(a_address + a_size, page_size());
+		const auto success = ::mprotect(std::bit_cast<void*>(begin), end - begin, a_protect) == 0;
+		detail::reprotect(begin, end, a_protect, success);
+#endif
+
+		if (a_old) {
+			*a_old = old;
+		}
+
+		return success;
+	}
+
+	// x86 keeps instruction cache coherent with stores, this only serializes for cross-modifying code
+	inline void flush_instruction_cache(std::uintptr_t a_address = 0, std::size_t a_size = 0) noexcept
+	{
+#if defined(_WIN32)
+		::FlushInstructionCache(::GetCurrentProcess(), std::bit_cast<void*>(a_address), a_size);
+#else
+		if (a_size) {
+			__builtin___clear_cache(std::bit_cast<char*>(a_address), std::bit_cast<char*>(a_address + a_size));
+		}
+#endif
+	}
+
+	/** \brief Append the ids of other threads of the process that are not in a_ids yet.
+	 * \brief a_ids never grows past its capacity and nothing else is allocated, this is safe while threads are suspended.
+	 * \return bool : false if a_ids ran out of capacity.
+	 */
+	[[nodiscard]] inline bool other_threads(std::vector<thread_id>& a_ids) noexcept
+	{
+		const auto append = [&a_ids](thread_id a_id) {
+			if (std::ranges::find(a_ids, a_id) != a_ids.end()) {
+				return true;
+			}
+
+			if (a_ids.size() == a_ids.capacity()) {
+				return false;
+			}
+
+			a_ids.push_back(a_id);
+			return true;
+		};
+
+		bool fits = true;
+#if defined(_WIN32)
+		// toolhelp snapshots are kernel sections, not process heap
+		auto snapshot = ::CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+		if (snapshot == INVALID_HANDLE_VALUE) {
+			return fits;
+		}
+
+		const auto    process = ::GetCurrentProcessId();
+		const auto    self = ::GetCurrentThreadId();
+		THREADENTRY32 entry{ .dwSize = sizeof(THREADENTRY32) };
+		for (auto found = ::Thread32First(snapshot, &entry); fits && found; found = ::Thread32Next(snapshot, &entry)) {
+			if (entry.th32OwnerProcessID == process && entry.th32ThreadID != self) {
+				fits = append(entry.th32ThreadID);
+			}
+		}
+
+		::CloseHandle(snapshot);
+#else
+		// raw getdents, opendir allocates
+		const auto dir = ::open("/proc/self/task", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (dir < 0) {
+			return fits;
+		}
+
+		const auto self = static_cast<thread_id>(::syscall(SYS_gettid));
+		alignas(8) char buffer[0x1000];
+		for (long read = 0; fits && (read = ::syscall(SYS_getdents64, dir, buffer, sizeof(buffer))) > 0;) {
+			for (long offset = 0; fits && offset < read;) {
+				const auto* entry = std::bit_cast<const ::dirent64*>(buffer + offset);
+				offset += entry->d_reclen;
+
+				thread_id  id{ 0 };
+				const auto name = std::string_view{ entry->d_name };
+				if (std::from_chars(name.data(), name.data() + name.size(), id).ec == std::errc{} && id != self) {
+					fits = append(id);
+				}
+			}
+		}
+
+		::close(dir);
+#endif
+
+		return fits;
+	}
+
+#if !defined(_WIN32)
+	/** \brief Whether a signal sent to a thread of this process reaches its handler, SigBlk and SigIgn of /proc/self/task/<tid>/status.
+	 * \brief Raw reads into a stack buffer, nothing is allocated, this is safe while other threads are parked.
+	 * \return bool : false if the thread blocks or the process ignores the signal, true if status cannot be read.
+	 */
+	[[nodiscard]] inline bool signal_deliverable(thread_id a_id, int a_signal) noexcept
+	{
+		constexpr std::string_view prefix = "/proc/self/task/";
+		constexpr std::string_view suffix = "/status";
+
+		char path[0x40]{};
+		auto* end = std::ranges::copy(prefix, path).out;
+		end = std::to_chars(end, path + sizeof(path) - suffix.size() - 1, a_id).ptr;
+		std::ranges::copy(suffix, end);
+
+		const auto file = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (file < 0) {
+			return true;
+		}
+
+		char        buffer[0x1000];
+		std::size_t size = 0;
+		for (long read = 0; size < sizeof(buffer) && (read = ::read(file, buffer + size, sizeof(buffer) - size)) > 0;) {
+			size += static_cast<std::size_t>(read);
+		}
+		::close(file);
+
+		// masks are hex with bit n - 1 set for signal n
+		const auto status = std::string_view{ buffer, size };
+		const auto mask = [status](std::string_view a_field) {
+			std::uint64_t value{ 0 };
+			if (const auto at = status.find(a_field); at != std::string_view::npos) {
+				const auto begin = status.data() + at + a_field.size();
+				std::from_chars(begin, status.data() + status.size(), value, 16);
+			}
+			return value;
+		};
+
+		const auto bit = static_cast<std::uint64_t>(1) << (a_signal - 1);
+		return !((mask("SigBlk:\t") | mask("SigIgn:\t")) & bit);
+	}
+#endif
+
+	// read only view of a whole file
+	struct MappedFile
+	{
+		const std::byte* data{ nullptr };
+		std::size_t      size{ 0 };
+	};
+
+	/** \brief Map a file read only into memory.
+	 * \return MappedFile : data is nullptr on failure, see last_error.
+	 */
+	[[nodiscard]] inline MappedFile map_file(const std::filesystem::path& a_path) noexcept
+	{
+#if defined(_WIN32)
+		const auto file = ::CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return {};
+		}
+
+		::LARGE_INTEGER size{};
+		::HANDLE        mapping{ nullptr };
+		void*           view{ nullptr };
+		if (::GetFileSizeEx(file, &size) && size.QuadPart) {
+			mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		}
+		if (mapping) {
+			view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			::CloseHandle(mapping);
+		}
+		::CloseHandle(file);
+
+		return view ? MappedFile{ static_cast<const std::byte*>(view), static_cast<std::size_t>(size.QuadPart) } : MappedFile{};
+#else
+		const auto file = ::open(a_path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file == -1) {
+			return {};
+		}
+
+		struct ::stat st{};
+		void*         view{ MAP_FAILED };
+		if (::fstat(file, &st) == 0 && st.st_size > 0) {
+			view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		}
+		::close(file);
+		invalidate_regions();
+
+		return view != MAP_FAILED ? MappedFile{ static_cast<const std::byte*>(view), static_cast<std::size_t>(st.st_size) } : MappedFile{};
+#endif
+	}
+
+	inline void unmap_file(const MappedFile& a_file) noexcept
+	{
+		if (!a_file.data) {
+			return;
+		}
+
+#if defined(_WIN32)
+		::UnmapViewOfFile(a_file.data);
+#else
+		::munmap(const_cast<std::byte*>(a_file.data), a_file.size);
+		invalidate_regions();
+#endif
+	}
+
+#if !defined(_WIN32)
+	[[nodiscard]] inline std::string executable_path() noexcept
+	{
+		std::error_code err;
+		return std::filesystem::read_symlink("/proc/self/exe", err).string();
+	}
+#endif
+
+#if defined(_WIN32)
+	namespace detail
+	{
+		// loader notification bumping a generation counter, unregistered on destruction
+		// so ntdll never calls into this module after it is unloaded
+		struct LoaderNotification
+		{
+			using notify_t = void (*)(::ULONG, const void*, void*);
+			using register_t = ::LONG (*)(::ULONG, notify_t, void*, void**);
+			using unregister_t = ::LONG (*)(void*);
+
+			LoaderNotification() noexcept
+			{
+				const auto ntdll = ::GetModuleHandleW(L"ntdll.dll");
+				const auto ldrRegister = std::bit_cast<register_t>(::GetProcAddress(ntdll, "LdrRegisterDllNotification"));
+				ldrUnregister = std::bit_cast<unregister_t>(::GetProcAddress(ntdll, "LdrUnregisterDllNotification"));
+
+				// registering without a way to unregister would leave ntdll calling unmapped code
+				if (!ldrRegister || !ldrUnregister ||
+					ldrRegister(0, [](::ULONG, const void*, void* a_generation) { static_cast<std::atomic_size_t*>(a_generation)->fetch_add(1, std::memory_order_release); },
+						std::addressof(generation), std::addressof(cookie)) < 0) {
+					cookie = nullptr;
+				}
+			}
+
+			~LoaderNotification() noexcept
+			{
+				if (cookie) {
+					ldrUnregister(cookie);
+				}
+			}
+
+			LoaderNotification(const LoaderNotification&) = delete;
+			LoaderNotification& operator=(const LoaderNotification&) = delete;
+
+			std::atomic_size_t generation{ 0 };
+			unregister_t       ldrUnregister{ nullptr };
+			void*              cookie{ nullptr };
+		};
+
+		// bumped by a loader notification registered on first call, nullptr if it cannot be registered
+		[[nodiscard]] inline std::atomic_size_t* loader_generation() noexcept
+		{
+			static LoaderNotification notification;
+			return notification.cookie ? std::addressof(notification.generation) : nullptr;
+		}
+	}  // namespace detail
+#endif
+
+	/** \brief Whether module_generation changes only when a module is loaded or unloaded.
+	 * \brief Always on elf, on windows only if the loader notification could be registered.
+	 */
+	[[nodiscard]] inline bool module_notifications() noexcept
+	{
+#if defined(_WIN32)
+		return detail::loader_generation() != nullptr;
+#else
+		return true;
+#endif
+	}
+
+	/** \brief Counter that changes whenever a module is loaded or unloaded.
+	 * \brief Windows registers a loader notification on first call and reading it is free, elf asks the dynamic linker.
+	 */
+	[[nodiscard]] inline std::size_t module_generation() noexcept
+	{
+#if defined(_WIN32)
+		static std::atomic_size_t fallback{ 0 };
+
+		// without notification every read is a new generation
+		const auto* generation = detail::loader_generation();
+		return generation ? generation->load(std::memory_order_acquire) : fallback.fetch_add(1, std::memory_order_relaxed);
+#else
+		std::size_t generation{ 0 };
+		::dl_iterate_phdr([](::dl_phdr_info* a_info, std::size_t, void* a_generation) -> int {
+			*static_cast<std::size_t*>(a_generation) = a_info->dlpi_adds + a_info->dlpi_subs;
+			return 1;
+		},
+			std::addressof(generation));
+
+		return generation;
+#endif
+	}
+
+#if !defined(_WIN32)
+	// loaded elf object, base is the page of its lowest segment and bias is added to its virtual addresses
+	struct LoadedObject
+	{
+		std::uintptr_t    base{ 0 };
+		std::uintptr_t    bias{ 0 };
+		const ElfW(Phdr)* programHeader{ nullptr };
+		std::size_t       programHeaderCount{ 0 };
+		std::string       path;
+	};
+
+	/** \brief Find a loaded object, objects are visited in load order and the main executable is the first.
+	 * \param a_pred : bool(const LoadedObject&), the first object it accepts is returned.
+	 * \return LoadedObject : std::nullopt if none is accepted.
+	 */
+	[[nodiscard]] inline std::optional<LoadedObject> find_object(std::function<bool(const LoadedObject&)> a_pred) noexcept
+	{
+		struct Search
+		{
+			std::function<bool(const LoadedObject&)>& pred;
+			std::optional<LoadedObject>               found;
+		} search{ a_pred, std::nullopt };
+
+		::dl_iterate_phdr([](::dl_phdr_info* a_info, std::size_t, void* a_search) -> int {
+			auto& search = *static_cast<Search*>(a_search);
+
+			auto lowest = std::numeric_limits<std::uintptr_t>::max();
+			for (std::size_t i = 0; i < a_info->dlpi_phnum; ++i) {
+				if (a_info->dlpi_phdr[i].p_type == PT_LOAD) {
+					lowest = (std::min)(lowest, static_cast<std::uintptr_t>(a_info->dlpi_phdr[i].p_vaddr));
+				}
+			}
+
+			if (lowest == std::numeric_limits<std::uintptr_t>::max()) {
+				return 0;
+			}
+
+			LoadedObject object{
+				.base = numbers::rounddown(a_info->dlpi_addr + lowest, page_size()),
+				.bias = a_info->dlpi_addr,
+				.programHeader = a_info->dlpi_phdr,
+				.programHeaderCount = a_info->dlpi_phnum,
+				.path = a_info->dlpi_name && *a_info->dlpi_name ? a_info->dlpi_name : executable_path(),
+			};
+
+			if (!search.pred(object)) {
+				return 0;
+			}
+
+			search.found = std::move(object);
+			return 1;
+		},
+			std::addressof(search));
+
+		return search.found;
+	}
+
+	// loaded object with a segment containing the address
+	[[nodiscard]] inline std::optional<LoadedObject> object_at(std::uintptr_t a_address) noexcept
+	{
+		return find_object([a_address](const LoadedObject& a_object) {
+			return std::ranges::any_of(std::span{ a_object.programHeader, a_object.programHeaderCount }, [&](auto& a_phdr) {
+				const auto begin = a_object.bias + a_phdr.p_vaddr;
+				return a_phdr.p_type == PT_LOAD && a_address >= numbers::rounddown(begin, page_size()) && a_address < begin + a_phdr.p_memsz;
+			});
+		});
+	}
+
+	// loaded object by file name or path, the main executable if empty
+	[[nodiscard]] inline std::optional<LoadedObject> object_named(std::string_view a_name) noexcept
+	{
+		return find_object([a_name](const LoadedObject& a_object) {
+			return a_name.empty() || a_object.path == a_name || std::filesystem::path(a_object.path).filename() == a_name;
+		});
+	}
+#endif
+
+	// image range of a loaded module
+	struct ModuleRange
+	{
+		std::uintptr_t base{ 0 };
+		std::size_t    size{ 0 };
+	};
+
+	[[nodiscard]] inline std::vector<ModuleRange> loaded_modules() noexcept
+	{
+		std::vector<ModuleRange> modules;
+#if defined(_WIN32)
+		std::vector<::HMODULE> handles(0x100);
+		::DWORD                needed{ 0 };
+		while (::EnumProcessModules(::GetCurrentProcess(), handles.data(), static_cast<::DWORD>(handles.size() * sizeof(::HMODULE)), &needed) &&
+			   needed > handles.size() * sizeof(::HMODULE)) {
+			handles.resize(needed / sizeof(::HMODULE));
+		}
+		handles.resize((std::min)(handles.size(), needed / sizeof(::HMODULE)));
+
+		for (const auto handle : handles) {
+			::MODULEINFO info{};
+			if (::GetModuleInformation(::GetCurrentProcess(), handle, &info, sizeof(info))) {
+				modules.emplace_back(std::bit_cast<std::uintptr_t>(info.lpBaseOfDll), info.SizeOfImage);
+			}
+		}
+#else
+		std::ignore = find_object([&](const LoadedObject& a_object) {
+			std::uintptr_t end{ 0 };
+			for (const auto& phdr : std::span{ a_object.programHeader, a_object.programHeaderCount }) {
+				if (phdr.p_type == PT_LOAD) {
+					end = (std::max)(end, static_cast<std::uintptr_t>(a_object.bias + phdr.p_vaddr + phdr.p_memsz));
+				}
+			}
+
+			modules.emplace_back(a_object.base, end - a_object.base);
+			return false;
+		});
+#endif
+
+		return modules;
+	}
+
+	// the loader knows a module containing the address, without listing every module
+	[[nodiscard]] inline bool module_contains(std::uintptr_t a_address) noexcept
+	{
+#if defined(_WIN32)
+		::HMODULE module{ nullptr };
+		return ::GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, std::bit_cast<::LPCWSTR>(a_address), &module) != FALSE;
+#else
+		return object_at(a_address).has_value();
+#endif
+	}
+}  // namespace DKUtil::Hook::Platform
@@ -1,10 +1,17 @@
 #pragma once
-#pragma comment(lib, "Version.lib")
+#if defined(_MSC_VER)
+#	pragma comment(lib, "Version.lib")
+#endif
 
-#include "DKUtil/Impl/pch.hpp"
+#include "DKUtil/Impl/PCH.hpp"
 #include "DKUtil/Logger.hpp"
 #include "DKUtil/Utility.hpp"
+#include "DKUtil/Impl/Hook/Disasm.hpp"
+#include "DKUtil/Impl/Hook/Platform.hpp"
 
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
 #include <xbyak/xbyak.h>
 #define AsAddress(PTR) std::bit_cast<std::uintptr_t>(PTR)
 #define AsPointer(ADDR) std::bit_cast<void*>(ADDR)
@@ -49,6 +56,7 @@ namespace DKUtil
 			kRestoreAfterProlog = 1u << 2,   // apply stolens after prolog
 			kRestoreBeforeEpilog = 1u << 3,  // apply stolens before epilog
 			kRestoreAfterEpilog = 1u << 4,   // apply stolens after epilog
+			kProfile = 1u << 5,              // count calls and cycles in HookStats
 		};
 
 		struct Patch
@@ -169,82 +177,71 @@ namespace DKUtil
 			std::fill_n(begin, a_size, val);
 		}
 
+		/**
+		 * \brief Decode the rip displacement or relative branch of an assembly instruction
+		 * \brief Example : `0F 84 21 43 65 87` -> { target, offset 2, size 4, length 6, kBranch }
+		 * \param a_src : Address of the assembly instruction. This must be the beginning of the full instruction
+		 * @return Disasm::Displacement, kind is kNone if the instruction has no rip displacement
+		 */
+		[[nodiscard]] inline Disasm::Displacement DecodeDisp(const model::concepts::dku_memory auto a_src) noexcept
+		{
+			// assumes assembly is safe to read
+			return Disasm::displacement(std::bit_cast<const OpCode*>(AsAddress(a_src)), AsAddress(a_src));
+		}
+
+		/**
+		 * \brief Decode the rip displacements or relative branches of many assembly instructions
+		 * \brief Example : `DecodeDisp(search_all("E8 ?? ?? ?? ?? 84 C0"))` -> every call target
+		 * \param a_srcs : Range of instruction addresses
+		 * @return Disasm::Displacement of each instruction in the given order
+		 */
+		template <std::ranges::input_range R>
+			requires(model::concepts::dku_memory<std::ranges::range_value_t<R>>)
+		[[nodiscard]] inline std::vector<Disasm::Displacement> DecodeDisp(R&& a_srcs) noexcept
+		{
+			std::vector<Disasm::Displacement> disps;
+			if constexpr (std::ranges::sized_range<R>) {
+				disps.reserve(std::ranges::size(a_srcs));
+			}
+
+			for (auto src : a_srcs) {
+				disps.push_back(DecodeDisp(src));
+			}
+
+			return disps;
+		}
+
 		/**
 		 * \brief Get the calculated address of the rip displacement in an assembly instruction
 		 * \brief Example : `FF 25 21 43 65 87` -> jmp qword ptr [rip + 0x87654321]
-		 * \brief Calculates and returns the actual address it branches to
+		 * \brief Calculates and returns the actual address it branches to, indirect call/jmp are dereferenced
 		 * \param T : Data type to read in at the calculated address
 		 * \param a_src : Address of the assembly instruction. This must be the beginning of the full instruction
-		 * \param a_opOffset : Optionally specify the offset where the displacement is, e.g. 1 for `E8 12 34 56 78`, 0 for auto
+		 * \param a_opOffset : Optionally specify the end offset of the displacement, e.g. 5 for `E8 12 34 56 78`, 0 for auto
 		 * @return Calculated address as T, std::uintptr_t by default
 		 */
 		template <typename T = std::uintptr_t>
 		inline T GetDisp(const model::concepts::dku_memory auto a_src, const std::uint8_t a_opOffset = 0) noexcept
 		{
 			// assumes assembly is safe to read
-			auto* opSeq = std::bit_cast<OpCode*>(a_src);
+			auto* opSeq = std::bit_cast<OpCode*>(AsAddress(a_src));
 			Imm64 dst = 0;
 
 			if (a_opOffset) {
 				auto disp = *adjust_pointer<Disp32>(opSeq, a_opOffset - sizeof(Disp32)) + a_opOffset;
 				dst = AsAddress(a_src) + disp;
 			} else {
-				// determine op
-				switch (opSeq[0]) {
-				// cd
-				case 0xE8:  // call disp32
-				case 0xE9:  // jmp disp32
-					{
-						auto disp = *adjust_pointer<Disp32>(opSeq, 5 - sizeof(Disp32)) + 5;
-						dst = AsAddress(a_src) + disp;
-					}
-					break;
-				// cb
-				case 0xEB:  // jmp disp8
-					{
-						auto disp = *adjust_pointer<Disp8>(opSeq, 2 - sizeof(Disp8)) + 2;
-						dst = AsAddress(a_src) + disp;
-					}
-					break;
-				// /2 | /4
-				case 0xFF:  // call/jmp modRM disp32
-					{
-						// FF /3 | /5 is not supported
-						dku_assert(opSeq[1] != 0x1D && opSeq[1] != 0x2D,
-							"DKU_H: GetDisp does not support reading FAR proc memory in different segment");
+				const auto disp = DecodeDisp(a_src);
 
-						auto disp = *adjust_pointer<Disp32>(opSeq, 6 - sizeof(Disp32)) + 6;
-						dst = AsAddress(a_src) + disp;
-						dst = *std::bit_cast<Imm64*>(dst);
-					}
-					break;
-				// mov/lea /r
-				case 0x88:
-				case 0x89:
-				case 0x8A:
-				case 0x8B:
-				case 0x8C:
-				case 0x8D:
-					{
-						auto disp = *adjust_pointer<Disp32>(opSeq, 6 - sizeof(Disp32)) + 6;
-						dst = AsAddress(a_src) + disp;
-					}
-					break;
-				// REX.W
-				case 0x48:
-				case 0x66:
-					{
-						// advance to the next op
-						dst = GetDisp(std::addressof(opSeq[1]));
-					}
-					break;
-				default:
-					break;
+				dku_assert(disp,
+					"DKU_H: GetDisp reads invalid relocation instruction\nsource : {:X}\nread-in : 0x{:2X}", AsAddress(a_src), opSeq[0]);
+
+				dst = disp.target;
+				if (disp.indirect) {
+					dst = *std::bit_cast<Imm64*>(dst);
 				}
 			}
 
-			dku_assert(dst, "DKU_H: GetDisp reads invalid relocation instruction\nsource : {:X}\nread-in : 0x{:2X}", AsAddress(a_src), opSeq[0]);
-
 			return std::bit_cast<T>(dst);
 		}
 
@@ -256,6 +253,25 @@ namespace DKUtil
 			return *newDisp;
 		}
 
+		/**
+		 * \brief Get the smallest instruction aligned offset pair to steal from an address
+		 * \brief Example : `48 89 5C 24 08 | 57 | 48 83 EC 20` with 6 minimum bytes -> { 0, 6 }
+		 * \param a_address : Address of the first instruction to steal
+		 * \param a_minBytes : Minimum bytes to cover, default to the size of a rel32 jmp
+		 * @return offset_pair for AddCaveHook/AddASMPatch, relative to a_address
+		 */
+		[[nodiscard]] inline offset_pair AutoOffset(const model::concepts::dku_memory auto a_address, const std::size_t a_minBytes = CAVE_MINIMUM_BYTES) noexcept
+		{
+			const auto* code = std::bit_cast<const OpCode*>(AsAddress(a_address));
+			const auto  length = Disasm::boundary(code, a_minBytes);
+
+			dku_assert(length,
+				"DKU_H: AutoOffset failed to decode instructions\nsource : {:X}\nread-in : 0x{:2X}",
+				AsAddress(a_address), code[0]);
+
+			return std::make_pair(0, static_cast<std::ptrdiff_t>(length));
+		}
+
 		constexpr void assert_trampoline_range(std::ptrdiff_t a_disp)
 		{
 			constexpr auto min = std::numeric_limits<std::int32_t>::min();
@@ -267,6 +283,7 @@ namespace DKUtil
 		[[nodiscard]] inline std::vector<std::uint32_t> GetFileVersion(std::string_view a_filename)
 		{
 			std::vector<std::uint32_t> version(4);
+#if defined(_WIN32)
 			std::uint32_t              dummy{ 0 };
 			std::vector<char>          buf(::GetFileVersionInfoSizeA(a_filename.data(), std::bit_cast<LPDWORD>(std::addressof(dummy))));
 			if (buf.empty()) {
@@ -284,32 +301,57 @@ namespace DKUtil
 			}
 
 			std::istringstream ss(std::string(static_cast<const char*>(verBuf), verLen));
-			std::string        token;
+#else
+			// shared object version from its file name, libfoo.so.1.2.3
+			const auto fileName = std::filesystem::path(a_filename).filename().string();
+			const auto suffix = fileName.find(".so.");
+			if (suffix == std::string::npos) {
+				return version;
+			}
+
+			std::istringstream ss(fileName.substr(suffix + 4));
+#endif
+			std::string token;
 			for (std::size_t i = 0; i < 4 && std::getline(ss, token, '.'); ++i) {
-				version[i] = static_cast<std::uint32_t>(std::stoi(token));
+				std::from_chars(token.data(), token.data() + token.size(), version[i]);
 			}
 
 			return version;
 		}
 
-		inline std::string GetModuleName(HMODULE a_handle = 0) noexcept
+		inline std::string GetModulePath(Platform::module_handle a_handle = 0) noexcept
 		{
-			std::string fileName(MAX_PATH + 1, '\0');
-			fileName.resize(::GetModuleBaseNameA(GetCurrentProcess(), a_handle, fileName.data(), MAX_PATH));
+#if defined(_WIN32)
+			std::string filePath(MAX_PATH + 1, '\0');
+			filePath.resize(::GetModuleFileNameA(a_handle, filePath.data(), MAX_PATH));
 
-			return fileName;
+			return filePath;
+#else
+			// module handle is the module base, as with HMODULE
+			if (!a_handle) {
+				return Platform::executable_path();
+			}
+
+			const auto object = Platform::object_at(AsAddress(a_handle));
+			return object ? object->path : std::string{};
+#endif
 		}
 
-		inline std::string GetModulePath(HMODULE a_handle = 0) noexcept
+		inline std::string GetModuleName(Platform::module_handle a_handle = 0) noexcept
 		{
-			std::string filePath(MAX_PATH + 1, '\0');
-			filePath.resize(::GetModuleFileNameA(a_handle, filePath.data(), MAX_PATH));
+#if defined(_WIN32)
+			std::string fileName(MAX_PATH + 1, '\0');
+			fileName.resize(::GetModuleBaseNameA(GetCurrentProcess(), a_handle, fileName.data(), MAX_PATH));
 
-			return filePath;
+			return fileName;
+#else
+			return std::filesystem::path(GetModulePath(a_handle)).filename().string();
+#endif
 		}
 
-		inline std::string GetProcessName(DWORD a_process) noexcept
+		inline std::string GetProcessPath(Platform::process_id a_process) noexcept
 		{
+#if defined(_WIN32)
 			HANDLE hProcess = ::OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, a_process);
 			if (!hProcess) {
 				return {};
@@ -322,17 +364,22 @@ namespace DKUtil
 				return {};
 			}
 
-			std::string modName(MAX_PATH + 1, '\0');
-			modName.resize(::GetModuleBaseNameA(hProcess, hMod, modName.data(), MAX_PATH));
-			if (modName.empty()) {
+			std::string modPath(MAX_PATH + 1, '\0');
+			modPath.resize(::GetModuleFileNameExA(hProcess, hMod, modPath.data(), MAX_PATH));
+			if (modPath.empty()) {
 				::CloseHandle(hProcess);
 			}
 
-			return modName;
+			return modPath;
+#else
+			std::error_code err;
+			return std::filesystem::read_symlink(fmt::format("/proc/{}/exe", a_process), err).string();
+#endif
 		}
 
-		inline std::string GetProcessPath(DWORD a_process) noexcept
+		inline std::string GetProcessName(Platform::process_id a_process) noexcept
 		{
+#if defined(_WIN32)
 			HANDLE hProcess = ::OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, a_process);
 			if (!hProcess) {
 				return {};
@@ -345,15 +392,23 @@ namespace DKUtil
 				return {};
 			}
 
-			std::string modPath(MAX_PATH + 1, '\0');
-			modPath.resize(::GetModuleFileNameExA(hProcess, hMod, modPath.data(), MAX_PATH));
-			if (modPath.empty()) {
+			std::string modName(MAX_PATH + 1, '\0');
+			modName.resize(::GetModuleBaseNameA(hProcess, hMod, modName.data(), MAX_PATH));
+			if (modName.empty()) {
 				::CloseHandle(hProcess);
 			}
 
-			return modPath;
+			return modName;
+#else
+			return std::filesystem::path(GetProcessPath(a_process)).filename().string();
+#endif
 		}
 
+		// export ordinal, a distinct type so a literal 0 or integer never picks the wrong export lookup
+		enum class ExportOrdinal : std::uint16_t
+		{
+		};
+
 		class Module
 		{
 		public:
@@ -377,6 +432,7 @@ namespace DKUtil
 				dku_assert(a_base, "DKU_H: Failed to initializing module info with null module base");
 
 				_base = AsAddress(a_base);
+#if defined(_WIN32)
 				_dosHeader = std::bit_cast<::IMAGE_DOS_HEADER*>(a_base);
 				_ntHeader = adjust_pointer<::IMAGE_NT_HEADERS64>(_dosHeader, _dosHeader->e_lfanew);
 				_sectionHeader = IMAGE_FIRST_SECTION(_ntHeader);
@@ -392,28 +448,84 @@ namespace DKUtil
 						}
 					}
 				}
+#else
+				const auto object = Platform::object_at(_base);
+				dku_assert(object && object->base == _base, "DKU_H: Failed to initializing module info, no loaded object at {:X}", _base);
+
+				_bias = object->bias;
+				_programHeader = object->programHeader;
+				_programHeaderCount = object->programHeaderCount;
+
+				// section headers are not mapped, segments are described instead
+				for (const auto& phdr : std::span{ _programHeader, _programHeaderCount }) {
+					auto name = Section::total;
+					switch (phdr.p_type) {
+					case PT_LOAD:
+						if (phdr.p_flags & PF_X) {
+							name = Section::textx;
+						} else if (phdr.p_flags & PF_W) {
+							name = Section::data;
+						} else {
+							name = Section::rdata;
+						}
+						break;
+					case PT_DYNAMIC:
+						name = Section::idata;
+						break;
+					case PT_GNU_EH_FRAME:
+						name = Section::pdata;
+						break;
+					case PT_TLS:
+						name = Section::tls;
+						break;
+					default:
+						continue;
+					}
+
+					// first executable and writable segment, last read only segment which holds rodata
+					auto& descriptor = _sections[std::to_underlying(name)];
+					if (!std::get<1>(descriptor) || name == Section::rdata) {
+						descriptor = std::make_tuple(name, _bias + phdr.p_vaddr, phdr.p_memsz);
+					}
+				}
+#endif
 
-				_version = GetFileVersion(GetModulePath(std::bit_cast<HMODULE>(a_base)));
+				_path = GetModulePath(std::bit_cast<Platform::module_handle>(a_base));
+				_version = GetFileVersion(_path);
 			}
 			explicit Module(std::string_view a_filePath)
 			{
+#if defined(_WIN32)
 				const auto base = AsAddress(::GetModuleHandleA(a_filePath.data())) & ~3;
+#else
+				const auto object = Platform::object_named(a_filePath);
+				const auto base = object ? object->base : 0;
+#endif
 				dku_assert(base, "DKU_H: Failed to initializing module info with file {}", a_filePath);
 
 				*this = Module(base);
 			}
 
 			[[nodiscard]] constexpr auto  base() const noexcept { return _base; }
+#if defined(_WIN32)
 			[[nodiscard]] constexpr auto* dosHeader() const noexcept { return _dosHeader; }
 			[[nodiscard]] constexpr auto* ntHeader() const noexcept { return _ntHeader; }
 			[[nodiscard]] constexpr auto* sectionHeader() const noexcept { return _sectionHeader; }
+#else
+			// load bias, added to virtual addresses in program headers and dynamic section
+			[[nodiscard]] constexpr auto  bias() const noexcept { return _bias; }
+			[[nodiscard]] constexpr auto* programHeader() const noexcept { return _programHeader; }
+			[[nodiscard]] constexpr auto  programHeaderCount() const noexcept { return _programHeaderCount; }
+#endif
 			[[nodiscard]] constexpr auto  section(Section a_section) noexcept
 			{
 				auto& [sec, addr, size] = _sections[std::to_underlying(a_section)];
 				return std::make_pair(addr, size);
 			}
 
-			[[nodiscard]] constexpr auto version() const noexcept { return _version; }
+			[[nodiscard]] constexpr auto& path() const noexcept { return _path; }
+			[[nodiscard]] const auto      name() const { return std::filesystem::path(_path).filename().string(); }
+			[[nodiscard]] constexpr auto  version() const noexcept { return _version; }
 			[[nodiscard]] const auto     version_string(std::string_view a_delim = "-"sv)
 			{
 				return fmt::format("{}{}{}{}{}{}{}", _version[0], a_delim, _version[1], a_delim, _version[2], a_delim, _version[3]);
@@ -428,54 +540,886 @@ namespace DKUtil
 					(_version[3] & 0x00F) << 0u);
 			}
 
-			[[nodiscard]] static Module& get(const model::concepts::dku_memory auto a_address) noexcept
+			/** \brief Import address table entry of an imported function, delay loaded imports included.
+			 * \brief All imports and exports are hashed on the first query of a module.
+			 * \param a_libraryName : case insensitive, not checked on elf as elf symbols are not bound to a library.
+			 * \param a_importName : case insensitive on pe.
+			 * \return void* : nullptr if not imported by name.
+			 */
+			[[nodiscard]] void* import_address(std::string_view a_libraryName, std::string_view a_importName) const
 			{
-				static std::unordered_map<std::uintptr_t, Module> managed;
+				const auto& symbols = index_symbols();
+				const auto  it = symbols.imports.find(import_key(a_libraryName, a_importName));
+				return it != symbols.imports.end() ? it->second : nullptr;
+			}
 
-				const auto base = AsAddress(a_address) & ~3;
-				if (!managed.contains(base)) {
-					managed.try_emplace(base, base);
-				}
+			/** \brief Address of an exported function or data, forwarded exports are not resolved.
+			 * \return void* : nullptr if not exported by name.
+			 */
+			[[nodiscard]] void* export_address(std::string_view a_exportName) const
+			{
+				const auto& symbols = index_symbols();
+				const auto  it = symbols.exports.find(std::string(a_exportName));
+				return it != symbols.exports.end() ? it->second : nullptr;
+			}
 
-				return managed.at(base);
+			// export by ordinal, always nullptr on elf
+			[[nodiscard]] void* export_address(ExportOrdinal a_ordinal) const
+			{
+				const auto& symbols = index_symbols();
+				const auto  it = symbols.ordinals.find(std::to_underlying(a_ordinal));
+				return it != symbols.ordinals.end() ? it->second : nullptr;
 			}
 
+			// module that contains the address, see ModuleRegistry
+			[[nodiscard]] static Module& get(const model::concepts::dku_memory auto a_address) noexcept;
+
 			[[nodiscard]] static Module& get(std::string_view a_filePath = {}) noexcept
 			{
+#if defined(_WIN32)
 				const auto base = AsAddress(::GetModuleHandleA(a_filePath.empty() ? GetModulePath().data() : a_filePath.data()));
+#else
+				const auto object = Platform::object_named(a_filePath);
+				const auto base = object ? object->base : 0;
+#endif
 				return get(base);
 			}
 
 		private:
-			std::uintptr_t                                                    _base;
-			::IMAGE_DOS_HEADER*                                               _dosHeader;
-			::IMAGE_NT_HEADERS64*                                             _ntHeader;
-			::IMAGE_SECTION_HEADER*                                           _sectionHeader;
+			struct Symbols
+			{
+				std::once_flag                           built;
+				std::unordered_map<std::string, void*>   imports;
+				std::unordered_map<std::string, void*>   exports;
+				std::unordered_map<std::uint16_t, void*> ordinals;
+			};
+
+			// library!import, lowered on pe where both are case insensitive
+			[[nodiscard]] static std::string import_key([[maybe_unused]] std::string_view a_libraryName, std::string_view a_importName)
+			{
+#if defined(_WIN32)
+				std::string key;
+				key.reserve(a_libraryName.size() + a_importName.size() + 1);
+				key.append(a_libraryName).append(1, '!').append(a_importName);
+				std::ranges::transform(key, key.begin(), [](unsigned char a_char) { return static_cast<char>(std::tolower(a_char)); });
+
+				return key;
+#else
+				return std::string(a_importName);
+#endif
+			}
+
+			const Symbols& index_symbols() const
+			{
+				std::call_once(_symbols->built, [this] {
+					auto& symbols = *_symbols;
+#if defined(_WIN32)
+					const auto& directories = _ntHeader->OptionalHeader.DataDirectory;
+
+					auto index_thunks = [&](const char* a_libraryName, std::uint32_t a_nameTbl, std::uint32_t a_iat) {
+						if (!a_nameTbl || !a_iat) {
+							return;
+						}
+
+						auto*       iat = adjust_pointer<::IMAGE_THUNK_DATA>(_dosHeader, a_iat);
+						const auto* thunk = adjust_pointer<const ::IMAGE_THUNK_DATA>(_dosHeader, a_nameTbl);
+						for (void(0); thunk->u1.AddressOfData; ++thunk, ++iat) {
+							if (thunk->u1.Ordinal & IMAGE_ORDINAL_FLAG) {
+								continue;
+							}
+
+							const auto* info = adjust_pointer<const ::IMAGE_IMPORT_BY_NAME>(_dosHeader, thunk->u1.AddressOfData);
+							symbols.imports.try_emplace(import_key(a_libraryName, std::bit_cast<const char*>(std::addressof(info->Name[0]))), iat);
+						}
+					};
+
+					if (const auto& dir = directories[IMAGE_DIRECTORY_ENTRY_IMPORT]; dir.VirtualAddress) {
+						for (auto* importTbl = adjust_pointer<const ::IMAGE_IMPORT_DESCRIPTOR>(_dosHeader, dir.VirtualAddress); importTbl->Name; ++importTbl) {
+							index_thunks(adjust_pointer<const char>(_dosHeader, importTbl->Name), importTbl->OriginalFirstThunk, importTbl->FirstThunk);
+						}
+					}
+
+					// delay loaded entries point to the loader thunk until the first call, which rebinds them
+					if (const auto& dir = directories[IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT]; dir.VirtualAddress) {
+						for (auto* delayTbl = adjust_pointer<const ::IMAGE_DELAYLOAD_DESCRIPTOR>(_dosHeader, dir.VirtualAddress); delayTbl->DllNameRVA; ++delayTbl) {
+							index_thunks(adjust_pointer<const char>(_dosHeader, delayTbl->DllNameRVA), delayTbl->ImportNameTableRVA, delayTbl->ImportAddressTableRVA);
+						}
+					}
+
+					if (const auto& dir = directories[IMAGE_DIRECTORY_ENTRY_EXPORT]; dir.VirtualAddress) {
+						const auto* exportTbl = adjust_pointer<const ::IMAGE_EXPORT_DIRECTORY>(_dosHeader, dir.VirtualAddress);
+						const auto* functions = adjust_pointer<const std::uint32_t>(_dosHeader, exportTbl->AddressOfFunctions);
+						const auto* names = adjust_pointer<const std::uint32_t>(_dosHeader, exportTbl->AddressOfNames);
+						const auto* nameOrdinals = adjust_pointer<const std::uint16_t>(_dosHeader, exportTbl->AddressOfNameOrdinals);
+
+						// forwarders point back into the export directory
+						auto resolve = [&](std::uint32_t a_index) -> void* {
+							const auto rva = functions[a_index];
+							return rva && (rva < dir.VirtualAddress || rva >= dir.VirtualAddress + dir.Size) ? AsPointer(_base + rva) : nullptr;
+						};
+
+						for (std::uint32_t idx = 0; idx < exportTbl->NumberOfFunctions; ++idx) {
+							if (auto* address = resolve(idx)) {
+								symbols.ordinals.try_emplace(static_cast<std::uint16_t>(exportTbl->Base + idx), address);
+							}
+						}
+
+						for (std::uint32_t idx = 0; idx < exportTbl->NumberOfNames; ++idx) {
+							if (auto* address = resolve(nameOrdinals[idx])) {
+								symbols.exports.try_emplace(adjust_pointer<const char>(_dosHeader, names[idx]), address);
+							}
+						}
+					}
+#else
+					const auto dynamic = std::get<1>(_sections[std::to_underlying(Section::idata)]);
+					if (!dynamic) {
+						return;
+					}
+
+					// glibc relocates dynamic entries in place, other loaders may not
+					const auto relocate = [bias = _bias](ElfW(Addr) a_ptr) { return a_ptr < bias ? a_ptr + bias : a_ptr; };
+
+					const ElfW(Sym)*     symtab{ nullptr };
+					const char*          strtab{ nullptr };
+					const ElfW(Rela)*    jmprel{ nullptr };
+					const ElfW(Rela)*    rela{ nullptr };
+					const ElfW(Word)*    hash{ nullptr };
+					const std::uint32_t* gnuHash{ nullptr };
+					std::size_t          jmprelSize{ 0 };
+					std::size_t          relaSize{ 0 };
+					for (auto* dyn = std::bit_cast<const ElfW(Dyn)*>(dynamic); dyn->d_tag != DT_NULL; ++dyn) {
+						switch (dyn->d_tag) {
+						case DT_SYMTAB:
+							symtab = std::bit_cast<const ElfW(Sym)*>(relocate(dyn->d_un.d_ptr));
+							break;
+						case DT_STRTAB:
+							strtab = std::bit_cast<const char*>(relocate(dyn->d_un.d_ptr));
+							break;
+						case DT_JMPREL:
+							jmprel = std::bit_cast<const ElfW(Rela)*>(relocate(dyn->d_un.d_ptr));
+							break;
+						case DT_PLTRELSZ:
+							jmprelSize = dyn->d_un.d_val;
+							break;
+						case DT_RELA:
+							rela = std::bit_cast<const ElfW(Rela)*>(relocate(dyn->d_un.d_ptr));
+							break;
+						case DT_RELASZ:
+							relaSize = dyn->d_un.d_val;
+							break;
+						case DT_HASH:
+							hash = std::bit_cast<const ElfW(Word)*>(relocate(dyn->d_un.d_ptr));
+							break;
+						case DT_GNU_HASH:
+							gnuHash = std::bit_cast<const std::uint32_t*>(relocate(dyn->d_un.d_ptr));
+							break;
+						default:
+							break;
+						}
+					}
+
+					if (!symtab || !strtab) {
+						return;
+					}
+
+					// lazily bound imports are jump slots, imports taken by address are global data
+					for (auto table : { std::span{ jmprel, jmprel ? jmprelSize / sizeof(ElfW(Rela)) : 0 }, std::span{ rela, rela ? relaSize / sizeof(ElfW(Rela)) : 0 } }) {
+						for (auto& entry : table) {
+							const auto type = ELF64_R_TYPE(entry.r_info);
+							if (type == R_X86_64_JUMP_SLOT || type == R_X86_64_GLOB_DAT) {
+								symbols.imports.try_emplace(strtab + symtab[ELF64_R_SYM(entry.r_info)].st_name, AsPointer(_bias + entry.r_offset));
+							}
+						}
+					}
+
+					// dynamic symbol count is the chain size of sysv hash, or one past the last gnu hash chain
+					std::size_t symbolCount{ 0 };
+					if (hash) {
+						symbolCount = hash[1];
+					} else if (gnuHash) {
+						const auto  bucketCount = gnuHash[0];
+						const auto  symbolOffset = gnuHash[1];
+						const auto* buckets = std::bit_cast<const std::uint32_t*>(std::bit_cast<const ElfW(Addr)*>(gnuHash + 4) + gnuHash[2]);
+						const auto* chains = buckets + bucketCount;
+
+						const auto last = bucketCount ? *std::ranges::max_element(std::span{ buckets, bucketCount }) : 0;
+						symbolCount = symbolOffset;
+						if (last >= symbolOffset) {
+							for (symbolCount = last; !(chains[symbolCount - symbolOffset] & 1); ++symbolCount) {}
+							++symbolCount;
+						}
+					}
+
+					for (const auto& symbol : std::span{ symtab, symbolCount }) {
+						const auto type = ELF64_ST_TYPE(symbol.st_info);
+						const auto bind = ELF64_ST_BIND(symbol.st_info);
+						if (symbol.st_shndx == SHN_UNDEF || !symbol.st_value ||
+							(type != STT_FUNC && type != STT_OBJECT) || (bind != STB_GLOBAL && bind != STB_WEAK)) {
+							continue;
+						}
+
+						symbols.exports.try_emplace(strtab + symbol.st_name, AsPointer(_bias + symbol.st_value));
+					}
+#endif
+
+					__DEBUG("DKU_H: Indexed {} imports | {} exports of module {:X}", symbols.imports.size(), symbols.exports.size(), _base);
+				});
+
+				return *_symbols;
+			}
+
+			std::uintptr_t _base;
+#if defined(_WIN32)
+			::IMAGE_DOS_HEADER*     _dosHeader;
+			::IMAGE_NT_HEADERS64*   _ntHeader;
+			::IMAGE_SECTION_HEADER* _sectionHeader;
+#else
+			std::uintptr_t    _bias;
+			const ElfW(Phdr)* _programHeader;
+			std::size_t       _programHeaderCount;
+#endif
 			std::array<SectionDescriptor, std::to_underlying(Section::total)> _sections;
+			std::string                                                       _path;
 			std::vector<std::uint32_t>                                        _version;
+			std::shared_ptr<Symbols>                                          _symbols{ std::make_shared<Symbols>() };
 		};
 
+		/** \brief Address to module lookup over every loaded module.
+		 * \brief Image ranges are kept in a sorted table and looked up by binary search. Lookups read an immutable snapshot of
+		 * \brief the table and take no lock, a new table is published when modules are loaded or unloaded. Modules are
+		 * \brief constructed on their first lookup and live until exit, even if unloaded.
+		 */
+		class ModuleRegistry
+		{
+		public:
+			struct Slot
+			{
+				std::uintptr_t       base{ 0 };
+				std::atomic<Module*> module{ nullptr };
+			};
+
+			struct Range
+			{
+				std::uintptr_t begin;
+				std::uintptr_t end;
+				Slot*          slot;
+			};
+
+			ModuleRegistry(const ModuleRegistry&) = delete;
+			ModuleRegistry& operator=(const ModuleRegistry&) = delete;
+
+			[[nodiscard]] static ModuleRegistry& get() noexcept
+			{
+				static ModuleRegistry registry;
+				return registry;
+			}
+
+			/** \brief Find the module whose image contains an address.
+			 * \return Module* : nullptr if the address is not in any loaded module.
+			 */
+			[[nodiscard]] Module* find(std::uintptr_t a_address) noexcept
+			{
+				// loader notifications make the generation free to read on windows, elf checks it only when nothing is found
+#if defined(_WIN32)
+				if (Platform::module_notifications() && stale()) {
+					std::unique_lock lock{ _lock };
+					if (stale()) {
+						rebuild();
+					}
+				}
+#endif
+
+				// without notifications every generation is new, a miss asks the loader for the address before listing all modules
+				auto* slot = lookup(a_address);
+				if (!slot && (Platform::module_notifications() ? stale() : Platform::module_contains(a_address))) {
+					slot = refresh_for(a_address);
+				}
+
+				if (!slot) {
+					return nullptr;
+				}
+
+				if (auto* module = slot->module.load(std::memory_order_acquire)) {
+					return module;
+				}
+
+				std::unique_lock lock{ _lock };
+				if (!slot->module.load(std::memory_order_relaxed)) {
+					slot->module.store(_modules.emplace_back(std::make_unique<Module>(slot->base)).get(), std::memory_order_release);
+				}
+
+				return slot->module.load(std::memory_order_relaxed);
+			}
+
+			// rebuild the range table from loaded modules
+			void refresh() noexcept
+			{
+				std::unique_lock lock{ _lock };
+				rebuild();
+			}
+
+			// current snapshot of image ranges, sorted by address
+			[[nodiscard]] std::span<const Range> ranges() const noexcept
+			{
+				return *_table.load(std::memory_order_acquire);
+			}
+
+		private:
+			ModuleRegistry() noexcept
+			{
+				refresh();
+			}
+
+			[[nodiscard]] bool stale() const noexcept
+			{
+				return _generation.load(std::memory_order_acquire) != Platform::module_generation();
+			}
+
+			// rebuild for a missed address, unless another thread did while this one waited for the lock
+			[[nodiscard]] Slot* refresh_for(std::uintptr_t a_address) noexcept
+			{
+				std::unique_lock lock{ _lock };
+				if (auto* slot = lookup(a_address)) {
+					return slot;
+				}
+
+				if (!Platform::module_notifications() || stale()) {
+					rebuild();
+				}
+
+				return lookup(a_address);
+			}
+
+			// _lock is held
+			void rebuild() noexcept
+			{
+				const auto generation = Platform::module_generation();
+				auto       table = std::make_unique<std::vector<Range>>();
+				for (const auto [base, size] : Platform::loaded_modules()) {
+					auto& slot = _slots[{ base, size }];
+					slot.base = base;
+					table->emplace_back(base, base + size, std::addressof(slot));
+				}
+				std::ranges::sort(*table, {}, &Range::begin);
+
+				// readers may still hold a previous table, they are kept alive
+				_table.store(_tables.emplace_back(std::move(table)).get(), std::memory_order_release);
+				_generation.store(generation, std::memory_order_release);
+
+				__DEBUG("DKU_H: ModuleRegistry indexed {} modules", _table.load(std::memory_order_relaxed)->size());
+			}
+
+			[[nodiscard]] Slot* lookup(std::uintptr_t a_address) const noexcept
+			{
+				const auto& table = *_table.load(std::memory_order_acquire);
+				auto        it = std::ranges::upper_bound(table, a_address, {}, &Range::begin);
+				if (it == table.begin() || a_address >= (--it)->end) {
+					return nullptr;
+				}
+
+				return it->slot;
+			}
+
+			std::atomic<const std::vector<Range>*>                 _table{ nullptr };
+			std::atomic_size_t                                     _generation{ 0 };
+			std::mutex                                             _lock;
+			std::map<std::pair<std::uintptr_t, std::size_t>, Slot> _slots;
+			std::vector<std::unique_ptr<Module>>                   _modules;
+			std::vector<std::unique_ptr<const std::vector<Range>>> _tables;
+		};
+
+		inline Module& Module::get(const model::concepts::dku_memory auto a_address) noexcept
+		{
+			auto* module = ModuleRegistry::get().find(AsAddress(a_address));
+			dku_assert(module, "DKU_H: No loaded module contains address {:X}", AsAddress(a_address));
+
+			return *module;
+		}
+
+		/** \brief Find the module whose image contains an address.
+		 * \return Module* : nullptr if the address is not in any loaded module.
+		 */
+		[[nodiscard]] inline Module* ModuleFor(const model::concepts::dku_memory auto a_address) noexcept
+		{
+			return ModuleRegistry::get().find(AsAddress(a_address));
+		}
+
 		// COMPAT
 #include "Shared_Compat.hpp"
 
+		/** \brief Collects memory writes and applies them at once, protection is changed once per touched page range.
+		 * \brief While a transaction is open on the current thread, WriteData/WriteImm/WritePatch to non-trampoline memory
+		 * \brief are queued into it, this includes HookHandle::Enable/Disable. Queued writes are applied in order on commit
+		 * \brief or destruction, memory read before that still holds the old bytes. Transactions can be nested.
+		 */
+		class PatchTransaction
+		{
+		public:
+			PatchTransaction() noexcept :
+				_previous(std::exchange(_active, this))
+			{}
+
+			// transactions of a thread are a stack, closing one that is not innermost would reopen a closed one
+			virtual ~PatchTransaction() noexcept
+			{
+				dku_assert(_active == this,
+					"DKU_H: PatchTransaction closed out of order, transactions must close in reverse order on the thread that opened them");
+
+				finish();
+				_active = _previous;
+			}
+
+			PatchTransaction(const PatchTransaction&) = delete;
+			PatchTransaction& operator=(const PatchTransaction&) = delete;
+
+			/** \brief Queue a write, data is copied into the transaction.
+			 * \param a_dst : destination address
+			 * \param a_data : source data
+			 * \param a_size : size of source data
+			 */
+			void write(const model::concepts::dku_memory auto a_dst, const void* a_data, const std::size_t a_size)
+			{
+				if (!a_size) {
+					return;
+				}
+
+				const auto* src = static_cast<const OpCode*>(a_data);
+				_writes.emplace_back(AsAddress(a_dst), std::vector<OpCode>(src, src + a_size));
+			}
+
+			/** \brief Apply all queued writes.
+			 * \return std::size_t : number of protection changes made
+			 */
+			std::size_t commit()
+			{
+				if (_writes.empty()) {
+					return 0;
+				}
+
+				const auto pageSize = Platform::page_size();
+
+				// page aligned ranges, merged when overlapping or adjacent
+				std::vector<std::pair<std::uintptr_t, std::uintptr_t>> ranges;
+				ranges.reserve(_writes.size());
+				for (auto& [dst, data] : _writes) {
+					ranges.emplace_back(numbers::rounddown(dst, pageSize), numbers::roundup(dst + data.size(), pageSize));
+				}
+				std::ranges::sort(ranges);
+
+				auto merged = ranges.begin();
+				for (auto it = std::next(ranges.begin()); it != ranges.end(); ++it) {
+					if (it->first <= merged->second) {
+						merged->second = (std::max)(merged->second, it->second);
+					} else {
+						*++merged = *it;
+					}
+				}
+				ranges.erase(std::next(merged), ranges.end());
+
+				// pages within a range may differ in protection, each region is restored individually
+				std::vector<std::tuple<std::uintptr_t, std::size_t, Platform::protection>> regions;
+				for (auto [begin, end] : ranges) {
+					while (begin < end) {
+						const auto region = Platform::query(begin);
+
+						const auto           size = (std::min)(end, region.base + region.size) - begin;
+						Platform::protection oldProtect;
+						const auto           success = size && Platform::protect(begin, size, Platform::EXECUTE_READWRITE, std::addressof(oldProtect));
+
+						dku_assert(success,
+							"DKU_H: Failed to unprotect memory for patch transaction, error code {}\n"
+							"at   : {:X}\nsize : {}",
+							Platform::last_error(), begin, size);
+
+						regions.emplace_back(begin, size, oldProtect);
+						begin += size;
+					}
+				}
+
+				apply();
+
+				for (auto& [begin, size, protect] : regions) {
+					dku_assert(Platform::protect(begin, size, protect),
+						"DKU_H: Failed to restore memory protection for patch transaction, error code {}\n"
+						"at   : {:X}\nsize : {}",
+						Platform::last_error(), begin, size);
+				}
+
+				__DEBUG("DKU_H: Committed {} writes in {} protection changes", _writes.size(), regions.size());
+
+				_writes.clear();
+				return regions.size();
+			}
+
+			/** \brief Drop all queued writes without applying them.
+			 */
+			void discard() noexcept { _writes.clear(); }
+
+			[[nodiscard]] std::size_t size() const noexcept { return _writes.size(); }
+			[[nodiscard]] bool        empty() const noexcept { return _writes.empty(); }
+
+			/** \brief Innermost transaction open on the current thread.
+			 * \return PatchTransaction* : nullptr if none is open.
+			 */
+			[[nodiscard]] static PatchTransaction* active() noexcept { return _active; }
+
+		protected:
+			using write_list = std::vector<std::pair<std::uintptr_t, std::vector<OpCode>>>;
+
+			// commit on close, writes that cannot be applied are fatal rather than silently dropped
+			void finish() noexcept
+			{
+				try {
+					commit();
+				} catch (const std::exception& e) {
+					FATAL("DKU_H: Failed to commit patch transaction on close\n{}", e.what());
+				}
+			}
+
+			// copy queued writes, all touched pages are writable at this point
+			virtual void apply()
+			{
+				for (auto& [dst, data] : _writes) {
+					std::memcpy(AsPointer(dst), data.data(), data.size());
+				}
+			}
+
+			write_list _writes;
+
+		private:
+			static inline thread_local PatchTransaction* _active{ nullptr };
+
+			PatchTransaction* _previous;
+		};
+
+		/** \brief PatchTransaction that is safe to commit while other threads are running the patched code.
+		 * \brief On commit all other threads of the process are stopped, windows suspends them and elsewhere they are parked
+		 * \brief at a safe point in a quiesce_signal handler. Threads are listed again until a listing finds no new thread.
+		 * \brief If any of them has its instruction pointer inside a patched range, they are all resumed and stopping is
+		 * \brief retried, up to MAX_RETRY times. Writes that fit in an aligned qword or oword are applied with a single
+		 * \brief atomic store.
+		 */
+		class InstallBatch : public PatchTransaction
+		{
+		public:
+			static constexpr std::size_t MAX_RETRY = 100;
+			static constexpr std::size_t MAX_THREADS = 0x1000;
+
+			InstallBatch() noexcept = default;
+
+			~InstallBatch() noexcept override
+			{
+				finish();
+			}
+
+#if !defined(_WIN32)
+			// real time signal that parks threads, threads blocking it cannot be stopped
+			[[nodiscard]] static int quiesce_signal() noexcept { return SIGRTMIN + 3; }
+#endif
+
+		protected:
+			void apply() override
+			{
+				// reserved before threads are stopped, nothing below may allocate while a stopped thread may hold the heap lock
+				std::vector<Platform::thread_id> ids;
+				ids.reserve(MAX_THREADS);
+#if defined(_WIN32)
+				std::vector<HANDLE> threads;
+				threads.reserve(MAX_THREADS);
+#else
+				std::call_once(_parkInstalled, install_park);
+#endif
+
+				std::size_t retry = 0;
+				std::size_t blocked = 0;
+				for (void(0); retry < MAX_RETRY; ++retry) {
+					ids.clear();
+#if defined(_WIN32)
+					const auto quiesced = suspend(ids, threads);
+#else
+					const auto quiesced = park(ids, blocked);
+#endif
+					if (quiesced) {
+						for (auto& [dst, data] : _writes) {
+							store(dst, data);
+						}
+					}
+
+#if defined(_WIN32)
+					for (auto thread : threads) {
+						::ResumeThread(thread);
+						::CloseHandle(thread);
+					}
+					threads.clear();
+#else
+					unpark();
+#endif
+
+					if (quiesced) {
+						break;
+					}
+
+					std::this_thread::sleep_for(1ms);
+				}
+
+				dku_assert(retry < MAX_RETRY,
+					"DKU_H: Failed to install batch, threads did not leave the patched code after {} retries",
+					MAX_RETRY);
+
+				// logged once threads run again, a parked thread may hold the logger lock
+				if (blocked) {
+					__WARN("DKU_H: Installed batch while {} threads block the quiesce signal, they were not stopped", blocked);
+				}
+
+				for (auto& [dst, data] : _writes) {
+					Platform::flush_instruction_cache(dst, data.size());
+				}
+				__DEBUG("DKU_H: Installed batch of {} writes with {} threads stopped, {} retries", _writes.size(), ids.size(), retry);
+			}
+
+		private:
+			// instruction pointer at the start of a patched range is safe, it executes the new bytes
+			[[nodiscard]] bool in_patch(const std::uintptr_t a_rip) const noexcept
+			{
+				return std::ranges::any_of(_writes, [a_rip](auto& a_write) {
+					return a_rip > a_write.first && a_rip < a_write.first + a_write.second.size();
+				});
+			}
+
+#if defined(_WIN32)
+			// threads created by threads not yet suspended show up in the next listing, until one finds none
+			[[nodiscard]] bool suspend(std::vector<Platform::thread_id>& a_ids, std::vector<HANDLE>& a_threads) const noexcept
+			{
+				for (std::size_t known = 0; Platform::other_threads(a_ids) && a_ids.size() != known;) {
+					for (void(0); known < a_ids.size(); ++known) {
+						if (auto thread = ::OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT, FALSE, a_ids[known])) {
+							if (::SuspendThread(thread) != static_cast<DWORD>(-1)) {
+								a_threads.push_back(thread);
+							} else {
+								::CloseHandle(thread);
+							}
+						}
+					}
+				}
+
+				dku_assert(a_ids.size() < a_ids.capacity(),
+					"DKU_H: Failed to install batch, process has more than {} threads", MAX_THREADS);
+
+				return std::ranges::none_of(a_threads, [this](auto a_thread) {
+					::CONTEXT context{};
+					context.ContextFlags = CONTEXT_CONTROL;
+					return ::GetThreadContext(a_thread, &context) && in_patch(context.Rip);
+				});
+			}
+#else
+			// round in the upper half of state, threads parked in this round in the lower half
+			struct Park
+			{
+				std::atomic<std::uint64_t>                            state{ 0 };
+				std::atomic<std::uint64_t>                            release{ 0 };
+				std::array<std::atomic<std::uintptr_t>, MAX_THREADS> rips{};
+				struct ::sigaction                                    previous{};
+			};
+
+			static constexpr auto PARK_TIMEOUT = 100ms;
+
+			static void install_park() noexcept
+			{
+				struct ::sigaction action{};
+				action.sa_sigaction = on_park;
+				action.sa_flags = SA_SIGINFO | SA_RESTART;
+				::sigemptyset(&action.sa_mask);
+
+				dku_assert(::sigaction(quiesce_signal(), &action, &parking().previous) == 0,
+					"DKU_H: Failed to install quiesce signal handler, error code {}", Platform::last_error());
+			}
+
+			// async signal safe, a thread records its instruction pointer then yields until its round is released, sched_yield is a plain syscall
+			static void on_park(int a_signal, ::siginfo_t* a_info, void* a_context) noexcept
+			{
+				auto& parked = parking();
+
+				if (a_info->si_code != SI_QUEUE || a_info->si_pid != ::getpid()) {
+					if (parked.previous.sa_flags & SA_SIGINFO) {
+						parked.previous.sa_sigaction(a_signal, a_info, a_context);
+					} else if (parked.previous.sa_handler != SIG_DFL && parked.previous.sa_handler != SIG_IGN) {
+						parked.previous.sa_handler(a_signal);
+					}
+					return;
+				}
+
+				// a signal of an abandoned round must not be counted in the current one
+				const auto round = static_cast<std::uint32_t>(a_info->si_value.sival_int);
+				auto       state = parked.state.load(std::memory_order_acquire);
+				do {
+					if ((state >> 32) != round || (state & 0xFFFFFFFF) >= MAX_THREADS) {
+						return;
+					}
+				} while (!parked.state.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel));
+
+				const auto rip = static_cast<std::uintptr_t>(static_cast<::ucontext_t*>(a_context)->uc_mcontext.gregs[REG_RIP]);
+				parked.rips[state & 0xFFFFFFFF].store(rip, std::memory_order_release);
+
+				while (parked.release.load(std::memory_order_acquire) < round) {
+					std::this_thread::yield();
+				}
+			}
+
+			// closes the round first, every thread counted in it has stored its instruction pointer before it is reused
+			static void unpark() noexcept
+			{
+				auto&      parked = parking();
+				const auto state = parked.state.load(std::memory_order_relaxed);
+				const auto round = state >> 32;
+				const auto count = parked.state.exchange((round << 32) | MAX_THREADS, std::memory_order_acq_rel) & 0xFFFFFFFF;
+				for (std::size_t i = 0; i < (std::min)(count, MAX_THREADS); ++i) {
+					while (!parked.rips[i].load(std::memory_order_acquire)) {
+						std::this_thread::yield();
+					}
+				}
+
+				parked.release.store(round, std::memory_order_release);
+			}
+
+			// threads created by threads not yet parked show up in the next listing, until one finds none
+			// threads that block or ignore the signal would never arrive, they are skipped and counted in a_blocked
+			[[nodiscard]] bool park(std::vector<Platform::thread_id>& a_ids, std::size_t& a_blocked) const noexcept
+			{
+				auto&      parked = parking();
+				const auto round = (parked.state.load(std::memory_order_relaxed) >> 32) + 1;
+				for (auto& rip : parked.rips) {
+					rip.store(0, std::memory_order_relaxed);
+				}
+				parked.state.store(round << 32, std::memory_order_release);
+
+				::siginfo_t info{};
+				info.si_signo = quiesce_signal();
+				info.si_code = SI_QUEUE;
+				info.si_pid = ::getpid();
+				info.si_uid = ::getuid();
+				info.si_value.sival_int = static_cast<int>(round);
+
+				std::size_t sent = 0;
+				a_blocked = 0;
+				for (std::size_t known = 0; Platform::other_threads(a_ids) && a_ids.size() != known;) {
+					for (void(0); known < a_ids.size(); ++known) {
+						if (!Platform::signal_deliverable(a_ids[known], info.si_signo)) {
+							++a_blocked;
+							continue;
+						}
+
+						// exited threads fail with ESRCH and are not waited for
+						if (::syscall(SYS_rt_tgsigqueueinfo, info.si_pid, a_ids[known], info.si_signo, &info) == 0) {
+							++sent;
+						}
+					}
+
+					// a thread that exits before handling the signal never arrives, the round is retried
+					const auto deadline = std::chrono::steady_clock::now() + PARK_TIMEOUT;
+					while ((parked.state.load(std::memory_order_acquire) & 0xFFFFFFFF) < sent) {
+						if (std::chrono::steady_clock::now() > deadline) {
+							return false;
+						}
+						std::this_thread::yield();
+					}
+				}
+
+				dku_assert(a_ids.size() < a_ids.capacity(),
+					"DKU_H: Failed to install batch, process has more than {} threads", MAX_THREADS);
+
+				for (std::size_t i = 0; i < sent; ++i) {
+					std::uintptr_t rip;
+					while (!(rip = parked.rips[i].load(std::memory_order_acquire))) {
+						std::this_thread::yield();
+					}
+
+					if (in_patch(rip)) {
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+			[[nodiscard]] static Park& parking() noexcept
+			{
+				static Park park;
+				return park;
+			}
+
+			static inline std::once_flag _parkInstalled;
+#endif
+
+			[[nodiscard]] static bool compare_exchange_oword(long long* a_dst, long long (&a_expected)[2], const long long (&a_desired)[2]) noexcept
+			{
+#if defined(_MSC_VER)
+				return ::_InterlockedCompareExchange128(a_dst, a_desired[1], a_desired[0], a_expected);
+#else
+				bool success;
+				__asm__ __volatile__("lock cmpxchg16b %1"
+									 : "=@ccz"(success), "+m"(*std::bit_cast<__int128*>(a_dst)), "+a"(a_expected[0]), "+d"(a_expected[1])
+									 : "b"(a_desired[0]), "c"(a_desired[1])
+									 : "memory");
+				return success;
+#endif
+			}
+
+			static void store(std::uintptr_t a_dst, const std::vector<OpCode>& a_data) noexcept
+			{
+				const auto qwordOffset = a_dst % sizeof(std::uint64_t);
+				const auto owordOffset = a_dst % (sizeof(std::uint64_t) * 2);
+
+				if (qwordOffset + a_data.size() <= sizeof(std::uint64_t)) {
+					std::atomic_ref<std::uint64_t> qword{ *std::bit_cast<std::uint64_t*>(a_dst - qwordOffset) };
+
+					auto value = qword.load();
+					std::memcpy(std::bit_cast<OpCode*>(&value) + qwordOffset, a_data.data(), a_data.size());
+					qword.store(value);
+				} else if (owordOffset + a_data.size() <= sizeof(std::uint64_t) * 2) {
+					auto* oword = std::bit_cast<long long*>(a_dst - owordOffset);
+
+					alignas(16) long long expected[2]{ oword[0], oword[1] };
+					alignas(16) long long desired[2];
+					do {
+						std::memcpy(desired, expected, sizeof(desired));
+						std::memcpy(std::bit_cast<OpCode*>(&desired[0]) + owordOffset, a_data.data(), a_data.size());
+					} while (!compare_exchange_oword(oword, expected, desired));
+				} else {
+					std::memcpy(AsPointer(a_dst), a_data.data(), a_data.size());
+				}
+			}
+		};
+
+		/** \brief Write data to memory.
+		 * \brief Trampoline memory is already executable and writable, its writes skip protection changes.
+		 * \brief Other writes are queued into the active PatchTransaction if one is open on the current thread.
+		 * \param a_requestAlloc : destination is trampoline memory and the size is allocated from trampoline
+		 */
 		inline void WriteData(const model::concepts::dku_memory auto a_dst, const void* a_data, const std::size_t a_size, bool a_requestAlloc = false) noexcept
 		{
 			if (a_requestAlloc) {
 				void(TRAM_ALLOC(a_size));
+				std::memcpy(AsPointer(a_dst), a_data, a_size);
+				return;
+			}
+
+			if (auto* transaction = PatchTransaction::active()) {
+				transaction->write(a_dst, a_data, a_size);
+				return;
 			}
 
-			DWORD oldProtect;
+			Platform::protection oldProtect;
 
-			auto success = ::VirtualProtect(AsPointer(a_dst), a_size, PAGE_EXECUTE_READWRITE, std::addressof(oldProtect));
-			if (success != FALSE) {
+			auto success = Platform::protect(AsAddress(a_dst), a_size, Platform::EXECUTE_READWRITE, std::addressof(oldProtect));
+			if (success) {
 				std::memcpy(AsPointer(a_dst), a_data, a_size);
-				success = ::VirtualProtect(AsPointer(a_dst), a_size, oldProtect, std::addressof(oldProtect));
+				success = Platform::protect(AsAddress(a_dst), a_size, oldProtect);
 			}
 
-			dku_assert(success != FALSE,
+			dku_assert(success,
 				"DKU_H: Failed to write data, error code {}\n"
 				"at   : {:X}\ndata : {:X}\nsize : {}\nalloc: {}",
-				success, AsAddress(a_dst), AsAddress(a_data), a_size, a_requestAlloc);
+				Platform::last_error(), AsAddress(a_dst), AsAddress(a_data), a_size, a_requestAlloc);
 		}
 
 		// imm
@@ -547,70 +1491,270 @@ namespace DKUtil
 			}
 		}
 
-		[[nodiscard]] inline void* GetImportAddress(std::string_view a_moduleName, std::string_view a_libraryName, std::string_view a_importName) noexcept
+		/** \brief Get the import address table entry of an imported function, delay loaded imports included.
+		 * \brief On elf this is the global offset table entry, a_libraryName is not checked as elf symbols are not bound to a library.
+		 */
+		[[nodiscard]] inline void* GetImportAddress(std::string_view a_moduleName, [[maybe_unused]] std::string_view a_libraryName, std::string_view a_importName) noexcept
 		{
+#if defined(_WIN32)
 			dku_assert(!a_libraryName.empty() && !a_importName.empty(),
 				"DKU_H: IAT hook must have valid library name & method name\nConsider using GetProcessName([Opt]HMODULE)");
+#else
+			dku_assert(!a_importName.empty(),
+				"DKU_H: IAT hook must have valid method name");
+#endif
 
-			auto&       module = Module::get(a_moduleName);
-			const auto* dosHeader = module.dosHeader();
-			const auto* importTbl = adjust_pointer<const ::IMAGE_IMPORT_DESCRIPTOR>(dosHeader, module.ntHeader()->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT].VirtualAddress);
+			return Module::get(a_moduleName).import_address(a_libraryName, a_importName);
+		}
 
-			for (void(0); importTbl->Characteristics; ++importTbl) {
-				const char* libraryName = adjust_pointer<const char>(dosHeader, importTbl->Name);
-				if (!string::iequals(a_libraryName, libraryName)) {
-					continue;
-				}
+		/** \brief Get the address of a function or data exported by name, forwarded exports are not resolved.
+		 */
+		[[nodiscard]] inline void* GetExportAddress(std::string_view a_moduleName, std::string_view a_exportName) noexcept
+		{
+			return Module::get(a_moduleName).export_address(a_exportName);
+		}
 
-				if (!importTbl->FirstThunk || !importTbl->OriginalFirstThunk) {
-					break;
+		[[nodiscard]] inline void* GetExportAddress(std::string_view a_moduleName, ExportOrdinal a_ordinal) noexcept
+		{
+			return Module::get(a_moduleName).export_address(a_ordinal);
+		}
+
+		// function boundaries of an address, see FunctionAt
+		struct FunctionRange
+		{
+			std::uintptr_t begin{ 0 };
+			std::uintptr_t end{ 0 };
+			std::uintptr_t primary{ 0 };
+			const void*    unwind{ nullptr };
+		};
+
+		namespace detail
+		{
+			// walks back to int3/ret padding, for code without unwind data
+			[[nodiscard]] inline std::uintptr_t scan_prolog(std::uintptr_t a_addr) noexcept
+			{
+				static std::unordered_map<std::uintptr_t, std::uintptr_t> cached;
+				static std::mutex                                         lock;
+				constexpr auto                                            abiBoundary = 0x8;
+				constexpr auto                                            minPadding = 0x2;
+				constexpr auto                                            maxWalkable = static_cast<size_t>(1) << 12;
+
+				std::unique_lock guard{ lock };
+
+				auto it = cached.find(a_addr);
+				if (it != cached.end()) {
+					return it->second;
 				}
 
-				const auto* iat = adjust_pointer<const ::IMAGE_THUNK_DATA>(dosHeader, importTbl->FirstThunk);
-				const auto* thunk = adjust_pointer<const ::IMAGE_THUNK_DATA>(dosHeader, importTbl->OriginalFirstThunk);
+				std::uintptr_t start = a_addr - (a_addr % abiBoundary);
+				std::uintptr_t end = start > maxWalkable ? start - maxWalkable : 0;
 
-				for (void(0); iat->u1.Function; ++thunk, ++iat) {
-					if (thunk->u1.Ordinal & IMAGE_ORDINAL_FLAG) {
-						continue;
+				for (std::uintptr_t current = start; current >= end; current -= abiBoundary) {
+					auto epilogue = *adjust_pointer<std::uint16_t>(AsPointer(current), -minPadding);
+					if (epilogue == 0xCCCC || epilogue == 0xCCC3) {
+						cached[a_addr] = current;
+						break;
 					}
+				}
 
-					const auto* info = adjust_pointer<const ::IMAGE_IMPORT_BY_NAME>(dosHeader, thunk->u1.AddressOfData);
+				return cached.try_emplace(a_addr, a_addr).first->second;
+			}
 
-					if (!string::iequals(a_importName, std::bit_cast<const char*>(std::addressof(info->Name[0])))) {
-						continue;
+#if !defined(_WIN32)
+			[[nodiscard]] inline std::uint64_t read_uleb(const std::uint8_t*& a_ptr) noexcept
+			{
+				std::uint64_t value{ 0 };
+				for (std::uint32_t shift = 0;; shift += 7) {
+					const auto byte = *a_ptr++;
+					value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+					if (!(byte & 0x80)) {
+						return value;
 					}
+				}
+			}
 
-					return AsPointer(iat);
+			// DW_EH_PE encoded pointer, absolute/pc/data relative fixed size forms as emitted by gcc, clang and lld
+			[[nodiscard]] inline std::optional<std::uintptr_t> read_encoded(const std::uint8_t*& a_ptr, std::uint8_t a_encoding, std::uintptr_t a_dataRel) noexcept
+			{
+				const auto     origin = AsAddress(a_ptr);
+				std::uintptr_t value{ 0 };
+				switch (a_encoding & 0x0F) {
+				case 0x00:  // absptr
+				case 0x04:  // udata8
+				case 0x0C:  // sdata8
+					std::memcpy(std::addressof(value), a_ptr, sizeof(std::uint64_t));
+					a_ptr += sizeof(std::uint64_t);
+					break;
+				case 0x03:  // udata4
+					value = *std::bit_cast<const std::uint32_t*>(a_ptr);
+					a_ptr += sizeof(std::uint32_t);
+					break;
+				case 0x0B:  // sdata4
+					value = static_cast<std::uintptr_t>(static_cast<std::intptr_t>(*std::bit_cast<const std::int32_t*>(a_ptr)));
+					a_ptr += sizeof(std::int32_t);
+					break;
+				default:
+					return std::nullopt;
+				}
+
+				switch (a_encoding & 0x70) {
+				case 0x00:
+					return value;
+				case 0x10:  // pcrel
+					return value + origin;
+				case 0x30:  // datarel
+					return value + a_dataRel;
+				default:
+					return std::nullopt;
 				}
 			}
 
-			return nullptr;
-		}
+			// pc range of a fde, its pointer encoding is given by the augmentation of its cie
+			[[nodiscard]] inline std::optional<std::pair<std::uintptr_t, std::uintptr_t>> read_fde(const std::uint8_t* a_fde) noexcept
+			{
+				if (*std::bit_cast<const std::uint32_t*>(a_fde) == 0xFFFFFFFF) {
+					return std::nullopt;
+				}
 
-		[[nodiscard]] inline std::uintptr_t GetFuncPrologAddr(std::uintptr_t a_addr)
-		{
-			static std::unordered_map<std::uintptr_t, std::uintptr_t> cached;
-			constexpr auto                                            abiBoundary = 0x8;
-			constexpr auto                                            minPadding = 0x2;
-			constexpr auto                                            maxWalkable = static_cast<size_t>(1) << 12;
+				const auto* ptr = a_fde + sizeof(std::uint32_t);
+				const auto* cie = ptr - *std::bit_cast<const std::uint32_t*>(ptr);
+				ptr += sizeof(std::uint32_t);
+
+				// length, id, version, augmentation, code and data alignment, return register
+				const auto* field = cie + 2 * sizeof(std::uint32_t);
+				const auto  version = *field++;
+				const auto* augmentation = std::bit_cast<const char*>(field);
+				field += std::strlen(augmentation) + 1;
+				if (augmentation[0] == 'e' && augmentation[1] == 'h') {
+					field += sizeof(void*);
+				}
+				std::ignore = read_uleb(field);
+				std::ignore = read_uleb(field);
+				if (version == 1) {
+					++field;
+				} else {
+					std::ignore = read_uleb(field);
+				}
 
-			auto it = cached.find(a_addr);
-			if (it != cached.end()) {
-				return it->second;
+				std::uint8_t encoding{ 0 };
+				if (augmentation[0] == 'z') {
+					std::ignore = read_uleb(field);
+					for (const auto* aug = augmentation + 1; *aug; ++aug) {
+						switch (*aug) {
+						case 'R':
+							encoding = *field++;
+							break;
+						case 'L':
+							++field;
+							break;
+						case 'P':
+							{
+								const auto personality = *field++;
+								if (!read_encoded(field, personality & 0x7F, 0)) {
+									return std::nullopt;
+								}
+							}
+							break;
+						case 'S':
+							break;
+						default:
+							return std::nullopt;
+						}
+					}
+				}
+
+				const auto begin = read_encoded(ptr, encoding, 0);
+				const auto range = read_encoded(ptr, encoding & 0x0F, 0);
+				if (!begin || !range) {
+					return std::nullopt;
+				}
+
+				return std::make_pair(*begin, *begin + *range);
 			}
+#endif
+		}  // namespace detail
 
-			std::uintptr_t start = a_addr - (a_addr % abiBoundary);
-			std::uintptr_t end = start > maxWalkable ? start - maxWalkable : 0;
+		/** \brief Get the function that contains an address, unwind data of the containing module is binary searched.
+		 * \brief Unwind data is .pdata on pe and .eh_frame_hdr on elf. Code without it, e.g. leaf functions on pe or code
+		 * \brief outside of any module, falls back to walking back to int3/ret padding, which finds no end or unwind.
+		 * \return FunctionRange : begin and end of the unwind entry containing the address, primary is the function the
+		 * \return entry belongs to and differs from begin for chained entries, unwind is UNWIND_INFO on pe and FDE on elf.
+		 */
+		[[nodiscard]] inline FunctionRange FunctionAt(std::uintptr_t a_address) noexcept
+		{
+			if (auto* module = ModuleFor(a_address)) {
+#if defined(_WIN32)
+				const auto& dir = module->ntHeader()->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXCEPTION];
+				const auto  table = std::span{ adjust_pointer<const ::RUNTIME_FUNCTION>(module->dosHeader(), dir.VirtualAddress), dir.VirtualAddress ? dir.Size / sizeof(::RUNTIME_FUNCTION) : 0 };
+				const auto  rva = static_cast<std::uint32_t>(a_address - module->base());
+
+				auto it = std::ranges::upper_bound(table, rva, {}, &::RUNTIME_FUNCTION::BeginAddress);
+				if (it != table.begin() && rva < (--it)->EndAddress) {
+					FunctionRange function{ module->base() + it->BeginAddress, module->base() + it->EndAddress };
+
+					// chained entries describe a part of a function and lead to its primary entry
+					const auto* entry = std::addressof(*it);
+					for (auto depth = 0; depth < 0x20; ++depth) {
+						if (entry->UnwindData & 1) {
+							entry = adjust_pointer<const ::RUNTIME_FUNCTION>(module->dosHeader(), entry->UnwindData & ~1u);
+							continue;
+						}
 
-			for (std::uintptr_t current = start; current >= end; current -= abiBoundary) {
-				auto epilogue = *adjust_pointer<std::uint16_t>(AsPointer(current), -minPadding);
-				if (epilogue == 0xCCCC || epilogue == 0xCCC3) {
-					cached[a_addr] = current;
-					break;
+						const auto* unwind = adjust_pointer<const std::uint8_t>(module->dosHeader(), entry->UnwindData);
+						if (!function.unwind) {
+							function.unwind = unwind;
+						}
+
+						if (!((unwind[0] >> 3) & UNW_FLAG_CHAININFO)) {
+							break;
+						}
+
+						// chained entry follows the unwind codes, which are padded to an even count
+						entry = adjust_pointer<const ::RUNTIME_FUNCTION>(unwind, 4 + ((unwind[2] + 1) & ~1) * sizeof(std::uint16_t));
+					}
+
+					function.primary = module->base() + entry->BeginAddress;
+					return function;
+				}
+#else
+				const auto [ehFrameHdr, size] = module->section(Module::Section::pdata);
+				const auto* header = std::bit_cast<const std::uint8_t*>(ehFrameHdr);
+				const auto* field = header + sizeof(std::uint32_t);
+
+				// version, eh_frame pointer, fde count and search table encodings, table is datarel sdata4 pairs
+				const auto frame = ehFrameHdr ? detail::read_encoded(field, header[1], 0) : std::nullopt;
+				const auto count = frame ? detail::read_encoded(field, header[2], 0) : std::nullopt;
+				if (count && header[0] == 1 && header[3] == 0x3B) {
+					struct Entry
+					{
+						std::int32_t location;
+						std::int32_t fde;
+					};
+
+					const auto table = std::span{ std::bit_cast<const Entry*>(field), static_cast<std::size_t>(*count) };
+					const auto location = static_cast<std::intptr_t>(a_address - ehFrameHdr);
+
+					auto it = std::ranges::upper_bound(table, location, {}, [](const Entry& a_entry) { return static_cast<std::intptr_t>(a_entry.location); });
+					if (it != table.begin()) {
+						const auto* fde = std::bit_cast<const std::uint8_t*>(ehFrameHdr + (--it)->fde);
+						if (const auto range = detail::read_fde(fde); range && a_address < range->second) {
+							return { range->first, range->second, range->first, fde };
+						}
+					}
 				}
+#endif
 			}
 
-			return cached.try_emplace(a_addr, a_addr).first->second;
+			const auto prolog = detail::scan_prolog(a_address);
+			return { prolog, 0, prolog, nullptr };
+		}
+
+		/** \brief Get the beginning of the function that contains an address.
+		 * \brief Primary function entry from unwind data, see FunctionAt.
+		 */
+		[[nodiscard]] inline std::uintptr_t GetFuncPrologAddr(std::uintptr_t a_addr)
+		{
+			return FunctionAt(a_addr).primary;
 		}
 
 		/**
@@ -618,13 +1762,13 @@ namespace DKUtil
 		 */
 		[[nodiscard]] inline std::uintptr_t GetRva(std::uintptr_t a_address)
 		{
-			const auto base = Module::get().base();
-			dku_assert(a_address > base,
+			const auto* module = ModuleFor(a_address);
+			dku_assert(module,
 				"DKU_H: Cannot calculate RVA from address {:X} "
-				"because it's not in the same memory region",
+				"because it's not in any loaded module",
 				a_address);
 
-			return a_address - base;
+			return a_address - module->base();
 		}
 
 		/**
@@ -8,6 +8,9 @@
 
 #	define TRAMPOLINE SKSE::GetTrampoline()
 #	define TRAM_ALLOC(SIZE) AsAddress((TRAMPOLINE).allocate((SIZE)))
+#	define TRAM_ALLOC_NEAR(SIZE, ADDR) TRAM_ALLOC(SIZE)
+#	define TRAM_INTERN(DATA, SIZE, ADDR) AsAddress(std::memcpy(AsPointer(TRAM_ALLOC(SIZE)), (DATA), (SIZE)))
+#	define TRAM_FREE(ADDR, SIZE) void(0)
 
 inline std::uintptr_t IDToAbs([[maybe_unused]] std::uint64_t a_ae, [[maybe_unused]] std::uint64_t a_se, [[maybe_unused]] std::uint64_t a_vr = 0) noexcept
 {
@@ -128,16 +131,28 @@ inline const unpacked_data RuntimePatch(
 #	include "F4SE/API.h"
 #	define TRAMPOLINE F4SE::GetTrampoline()
 #	define TRAM_ALLOC(SIZE) AsAddress((TRAMPOLINE).allocate((SIZE)))
+#	define TRAM_ALLOC_NEAR(SIZE, ADDR) TRAM_ALLOC(SIZE)
+#	define TRAM_INTERN(DATA, SIZE, ADDR) AsAddress(std::memcpy(AsPointer(TRAM_ALLOC(SIZE)), (DATA), (SIZE)))
+#	define TRAM_FREE(ADDR, SIZE) void(0)
 #elif defined(SFSEAPI) && !defined(PLUGIN_MODE)
 #	include "SFSE/API.h"
 #	define TRAMPOLINE SFSE::GetTrampoline()
 #	define TRAM_ALLOC(SIZE) AsAddress((TRAMPOLINE).allocate((SIZE)))
+#	define TRAM_ALLOC_NEAR(SIZE, ADDR) TRAM_ALLOC(SIZE)
+#	define TRAM_INTERN(DATA, SIZE, ADDR) AsAddress(std::memcpy(AsPointer(TRAM_ALLOC(SIZE)), (DATA), (SIZE)))
+#	define TRAM_FREE(ADDR, SIZE) void(0)
 #elif defined(PLUGIN_MODE)
 namespace Trampoline
 {
 	extern inline void* Allocate(std::size_t a_size);
+	extern inline void* Allocate(std::size_t a_size, std::uintptr_t a_near);
+	extern inline void* Intern(const void* a_data, std::size_t a_size, std::uintptr_t a_near);
+	extern inline void  Deallocate(void* a_mem, std::size_t a_size);
 }
 #	define TRAM_ALLOC(SIZE) AsAddress(Trampoline::Allocate(SIZE))
+#	define TRAM_ALLOC_NEAR(SIZE, ADDR) AsAddress(Trampoline::Allocate((SIZE), AsAddress(ADDR)))
+#	define TRAM_INTERN(DATA, SIZE, ADDR) AsAddress(Trampoline::Intern((DATA), (SIZE), AsAddress(ADDR)))
+#	define TRAM_FREE(ADDR, SIZE) Trampoline::Deallocate(AsPointer(ADDR), (SIZE))
 #endif
 
 #if defined(SFSEAPI)
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "PatternSet.hpp"
+
+namespace DKUtil::Hook::Assembly
+{
+	/** \brief Persistent pattern -> RVA cache, keyed by module version and a hash of its code section headers.
+	 * \brief Cached RVAs are confirmed with a masked compare at the cached address before being returned,
+	 * \brief only misses and stale entries are scanned. The cache file is rewritten on destruction if changed.
+	 * \brief A hit is the match found when the entry was stored, code before it is not rescanned, so a match created
+	 * \brief earlier in textx since, e.g. by another runtime patch, is not returned where search_pattern would return it.
+	 */
+	class SignatureCache
+	{
+	public:
+		static constexpr auto MAGIC = "DKU_H_SIGCACHE"sv;
+		static constexpr auto REVISION = 1u;
+
+		explicit SignatureCache(std::filesystem::path a_path, Module& a_module = Module::get()) :
+			_path(std::move(a_path)), _module(a_module), _version(a_module.version_number()), _hash(hash_headers(a_module))
+		{
+			load();
+		}
+
+		~SignatureCache() noexcept
+		{
+			save();
+		}
+
+		SignatureCache(const SignatureCache&) = delete;
+		SignatureCache& operator=(const SignatureCache&) = delete;
+
+		/** \brief Resolve a pattern from cache, scan module textx on miss.
+		 * \param a_pattern : hex string pattern, same syntax as search_pattern.
+		 * \return std::byte* : match, nullptr if none found.
+		 */
+		[[nodiscard]] std::byte* resolve(std::string_view a_pattern)
+		{
+			auto pattern = Pattern::sanitize(a_pattern);
+			if (auto* cached = lookup(pattern)) {
+				return cached;
+			}
+
+			auto [textx, size] = _module.section(Module::Section::textx);
+			auto* match = search_pattern(pattern, textx, size);
+			store(pattern, match);
+
+			return match;
+		}
+
+		/** \brief Resolve many patterns from cache, all misses are scanned in a single pass.
+		 * \param a_patterns : hex string patterns, same syntax as search_pattern.
+		 * \return match table : match of each pattern in the given order, nullptr if not found.
+		 */
+		[[nodiscard]] PatternSet::match_table resolve(std::span<const std::string_view> a_patterns)
+		{
+			PatternSet::match_table                          matches(a_patterns.size(), nullptr);
+			PatternSet                                       misses;
+			std::vector<std::pair<std::size_t, std::string>> pending;
+
+			for (std::size_t i = 0; i < a_patterns.size(); ++i) {
+				auto pattern = Pattern::sanitize(a_patterns[i]);
+				if (auto* cached = lookup(pattern)) {
+					matches[i] = cached;
+				} else {
+					misses.add(pattern);
+					pending.emplace_back(i, std::move(pattern));
+				}
+			}
+
+			if (!misses.empty()) {
+				auto [textx, size] = _module.section(Module::Section::textx);
+				auto scanned = misses.search(textx, size);
+				for (std::size_t id = 0; id < pending.size(); ++id) {
+					auto& [index, pattern] = pending[id];
+					matches[index] = scanned[id];
+					store(pattern, scanned[id]);
+				}
+			}
+
+			__DEBUG("DKU_H: SignatureCache resolved {} patterns, {} hits | {} misses", a_patterns.size(), _hits, _misses);
+
+			return matches;
+		}
+
+		/** \brief Write cache file if any entry has changed.
+		 * \return bool : false if the cache file cannot be written, entries are kept and written on the next save.
+		 */
+		bool save() noexcept
+		{
+			if (!_dirty) {
+				return true;
+			}
+
+			// formatting and stream allocation may throw, a failed save must not escape the destructor
+			try {
+				std::error_code err;
+				if (_path.has_parent_path()) {
+					std::filesystem::create_directories(_path.parent_path(), err);
+				}
+
+				std::ofstream file{ _path, std::ios::trunc };
+				if (!file.is_open()) {
+					__WARN("DKU_H: SignatureCache cannot write to {}", _path.string());
+					return false;
+				}
+
+				file << fmt::format("{} {} {:08X} {:016X}\n", MAGIC, REVISION, _version, _hash);
+				for (auto& [pattern, entry] : _entries) {
+					file << fmt::format("{:X} {}\n", entry.rva, pattern);
+				}
+
+				_dirty = !file.good();
+			} catch (const std::exception& e) {
+				__WARN("DKU_H: SignatureCache failed to save {}\n{}", _path.string(), e.what());
+				return false;
+			}
+
+			return !_dirty;
+		}
+
+		void clear() noexcept
+		{
+			_entries.clear();
+			_dirty = true;
+		}
+
+		[[nodiscard]] constexpr std::size_t hits() const noexcept { return _hits; }
+		[[nodiscard]] constexpr std::size_t misses() const noexcept { return _misses; }
+		[[nodiscard]] std::size_t           size() const noexcept { return _entries.size(); }
+
+	private:
+		// code section headers and image timestamp, code segment headers and build id on elf,
+		// changes whenever the code layout changes
+		[[nodiscard]] static std::uint64_t hash_headers(Module& a_module) noexcept
+		{
+			std::uint64_t hash = 14695981039346656037ull;
+			auto          fnv = [&](const void* a_data, std::size_t a_size) {
+				for (auto* byte = static_cast<const std::uint8_t*>(a_data); a_size; --a_size) {
+					hash = (hash ^ *byte++) * 1099511628211ull;
+				}
+			};
+
+#if defined(_WIN32)
+			const auto* ntHeader = a_module.ntHeader();
+			fnv(std::addressof(ntHeader->FileHeader.TimeDateStamp), sizeof(ntHeader->FileHeader.TimeDateStamp));
+			fnv(std::addressof(ntHeader->OptionalHeader.SizeOfImage), sizeof(ntHeader->OptionalHeader.SizeOfImage));
+
+			const auto* sections = a_module.sectionHeader();
+			for (std::size_t i = 0; i < ntHeader->FileHeader.NumberOfSections; ++i) {
+				if (sections[i].Characteristics & IMAGE_SCN_CNT_CODE) {
+					fnv(std::addressof(sections[i]), sizeof(sections[i]));
+				}
+			}
+#else
+			for (const auto& phdr : std::span{ a_module.programHeader(), a_module.programHeaderCount() }) {
+				if (phdr.p_type == PT_LOAD && phdr.p_flags & PF_X) {
+					fnv(std::addressof(phdr), sizeof(phdr));
+				} else if (phdr.p_type == PT_NOTE) {
+					fnv(AsPointer(a_module.bias() + phdr.p_vaddr), phdr.p_memsz);
+				}
+			}
+#endif
+
+			return hash;
+		}
+
+		void load()
+		{
+			std::ifstream file{ _path };
+			if (!file.is_open()) {
+				return;
+			}
+
+			std::string   magic;
+			std::uint32_t revision{ 0 };
+			std::string   version;
+			std::string   hash;
+			file >> magic >> revision >> version >> hash;
+
+			if (magic != MAGIC || revision != REVISION ||
+				std::strtoul(version.c_str(), nullptr, 16) != _version ||
+				std::strtoull(hash.c_str(), nullptr, 16) != _hash) {
+				__DEBUG("DKU_H: SignatureCache {} is stale, discarded", _path.string());
+				_dirty = true;
+				return;
+			}
+
+			std::string line;
+			while (std::getline(file, line)) {
+				const auto split = line.find(' ');
+				if (split == std::string::npos) {
+					continue;
+				}
+
+				const auto rva = std::strtoull(line.c_str(), nullptr, 16);
+				_entries.insert_or_assign(line.substr(split + 1), Entry{ static_cast<std::uintptr_t>(rva) });
+			}
+
+			__DEBUG("DKU_H: SignatureCache loaded {} entries from {}", _entries.size(), _path.string());
+		}
+
+		// cached rva must still match the pattern, compiled on the first lookup of an entry
+		[[nodiscard]] std::byte* lookup(const std::string& a_pattern)
+		{
+			auto it = _entries.find(a_pattern);
+			if (it == _entries.end()) {
+				++_misses;
+				return nullptr;
+			}
+
+			auto& entry = it->second;
+			if (!entry.compiled) {
+				entry.compiled = Pattern::compile(a_pattern);
+			}
+
+			const auto [textx, size] = _module.section(Module::Section::textx);
+			const auto address = _module.base() + entry.rva;
+			const auto& pattern = *entry.compiled;
+
+			if (address < textx || address + pattern.size > textx + size ||
+				!Pattern::detail::verify_scalar(static_cast<const std::byte*>(AsPointer(address)), pattern)) {
+				__DEBUG("DKU_H: SignatureCache entry {:X} is stale\npattern : {}", entry.rva, a_pattern);
+				_entries.erase(it);
+				_dirty = true;
+				++_misses;
+				return nullptr;
+			}
+
+			++_hits;
+			return static_cast<std::byte*>(AsPointer(address));
+		}
+
+		void store(const std::string& a_pattern, const std::byte* a_match)
+		{
+			if (!a_match) {
+				return;
+			}
+
+			_entries.insert_or_assign(a_pattern, Entry{ AsAddress(a_match) - _module.base() });
+			_dirty = true;
+		}
+
+		struct Entry
+		{
+			std::uintptr_t                          rva;
+			std::optional<Pattern::CompiledPattern> compiled{};
+		};
+
+		std::filesystem::path                  _path;
+		Module&                                _module;
+		const std::uint32_t                    _version;
+		const std::uint64_t                    _hash;
+		std::unordered_map<std::string, Entry> _entries;
+		std::size_t                            _hits{ 0 };
+		std::size_t                            _misses{ 0 };
+		bool                                   _dirty{ false };
+	};
+}  // namespace DKUtil::Hook::Assembly
@@ -1,79 +1,341 @@
 #pragma once
 
-#include "shared.hpp"
+#include "Shared.hpp"
 
 namespace DKUtil::Hook::Trampoline
 {
-	// partially taken from CommonLibSSE
-	class Trampoline : public model::Singleton<Trampoline>
+	// rel32 reach from a hook site, with margin for the hook offset into its function
+	inline constexpr std::size_t REACH = (static_cast<std::size_t>(1) << 31) - 0x100000;
+
+	namespace detail
 	{
-	public:
-		// https://stackoverflow.com/a/54732489/17295222
-		std::byte* PageAlloc(const std::size_t a_size, std::uintptr_t a_from = 0) noexcept
+		[[nodiscard]] inline std::size_t granularity() noexcept
 		{
-			release();
-
-			constexpr std::size_t    gigabyte = static_cast<std::size_t>(1) << 30;
-			constexpr std::size_t    minRange = gigabyte * 2;
-			constexpr std::uintptr_t maxAddr = std::numeric_limits<std::uintptr_t>::max();
-
-			::DWORD       granularity;
+#if defined(_WIN32)
 			::SYSTEM_INFO si;
 			::GetSystemInfo(&si);
-			granularity = si.dwAllocationGranularity;
+			return si.dwAllocationGranularity;
+#else
+			// match windows allocation granularity, also keeps probing steps coarse
+			return (std::max)(Platform::page_size(), static_cast<std::size_t>(0x10000));
+#endif
+		}
 
-			if (!a_from) {
-				const auto textx = Module::get().section(Module::Section::textx);
-				a_from = textx.first + textx.second;
+		[[nodiscard]] inline constexpr std::size_t distance(std::uintptr_t a_lhs, std::uintptr_t a_rhs) noexcept
+		{
+			return a_lhs > a_rhs ? a_lhs - a_rhs : a_rhs - a_lhs;
+		}
+
+		// fnv-1a over thunk bytes
+		[[nodiscard]] inline std::uint64_t hash(const void* a_data, std::size_t a_size) noexcept
+		{
+			std::uint64_t hash = 14695981039346656037ull;
+			for (auto* byte = static_cast<const std::uint8_t*>(a_data); a_size; --a_size) {
+				hash = (hash ^ *byte++) * 1099511628211ull;
 			}
 
-			std::uintptr_t       min = a_from >= minRange ? numbers::roundup(a_from - minRange, granularity) : 0;
-			const std::uintptr_t max = a_from < (maxAddr - minRange) ? numbers::rounddown(a_from + minRange, granularity) : maxAddr;
-			std::uintptr_t       addr = 0;
+			return hash;
+		}
+
+		/** \brief Reserve executable memory with its whole span within REACH of an address, nearest first.
+		 * \param a_size : size of memory to reserve, rounded up to allocation granularity.
+		 * \param a_from : address the memory must be reachable from.
+		 * \return std::byte* : reserved memory, nullptr if no free range is within reach.
+		 */
+		// https://stackoverflow.com/a/54732489/17295222
+		[[nodiscard]] inline std::byte* reserve_near(std::size_t a_size, std::uintptr_t a_from) noexcept
+		{
+			constexpr std::uintptr_t maxAddr = std::numeric_limits<std::uintptr_t>::max();
+
+			const auto gran = granularity();
+			a_size = numbers::roundup(a_size, gran);
+			if (a_size >= REACH) {
+				return nullptr;
+			}
+
+			const std::uintptr_t min = a_from >= REACH ? numbers::roundup(a_from - REACH, gran) : gran;
+			const std::uintptr_t max = a_from < (maxAddr - REACH) ? numbers::rounddown(a_from + REACH - a_size, gran) : maxAddr - a_size;
+
+#if defined(_WIN32)
+			// every free range within reach, its closest aligned address to a_from
+			std::vector<std::uintptr_t> candidates;
 
 			::MEMORY_BASIC_INFORMATION mbi;
-			do {
-				if (!::VirtualQuery(AsPointer(min), &mbi, sizeof(mbi))) {
-					break;
+			for (auto addr = min; addr < max + a_size && ::VirtualQuery(AsPointer(addr), &mbi, sizeof(mbi)); addr = AsAddress(mbi.BaseAddress) + mbi.RegionSize) {
+				if (mbi.State != MEM_FREE || mbi.RegionSize < a_size) {
+					continue;
+				}
+
+				const auto lo = (std::max)(numbers::roundup(AsAddress(mbi.BaseAddress), gran), min);
+				const auto hi = (std::min)(numbers::rounddown(AsAddress(mbi.BaseAddress) + mbi.RegionSize - a_size, gran), max);
+				if (lo <= hi) {
+					candidates.push_back(std::clamp(numbers::rounddown(a_from, gran), lo, hi));
+				}
+			}
+
+			std::ranges::sort(candidates, {}, [a_from](auto a_addr) { return distance(a_addr, a_from); });
+			for (auto addr : candidates) {
+				if (auto* data = ::VirtualAlloc(AsPointer(addr), a_size, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE)) {
+					return static_cast<std::byte*>(data);
+				}
+			}
+#else
+			// probe outward from a_from, MAP_FIXED_NOREPLACE fails on any existing mapping
+			const auto origin = numbers::rounddown(a_from, gran);
+			const auto try_map = [a_size](std::uintptr_t a_addr) -> std::byte* {
+				auto* data = ::mmap(AsPointer(a_addr), a_size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+				if (data == MAP_FAILED) {
+					return nullptr;
+				}
+
+				// kernels before 4.17 treat the hint as advisory
+				if (AsAddress(data) != a_addr) {
+					::munmap(data, a_size);
+					return nullptr;
 				}
 
-				min = AsAddress(mbi.BaseAddress) + mbi.RegionSize;
+				Platform::invalidate_regions();
+				return static_cast<std::byte*>(data);
+			};
 
-				if (mbi.State == MEM_FREE) {
-					addr = numbers::roundup(AsAddress(mbi.BaseAddress), granularity);
+			for (std::uintptr_t step = 0; step <= REACH; step += gran) {
+				if (const auto up = origin + step; up >= min && up <= max) {
+					if (auto* data = try_map(up)) {
+						return data;
+					}
+				}
 
-					if (addr < min && a_size <= (min - addr)) {
-						if (auto* data = ::VirtualAlloc(AsPointer(addr), a_size, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE)) {
-							_capacity = a_size;
-							_data = static_cast<std::byte*>(data);
-							break;
-						}
+				if (const auto down = origin - step; step && origin >= step && down >= min && down <= max) {
+					if (auto* data = try_map(down)) {
+						return data;
 					}
 				}
+			}
+#endif
+
+			return nullptr;
+		}
+	}  // namespace detail
+
+	// one block of trampoline memory, allocations are served from power of two size class slabs,
+	// freed blocks are kept in per class free lists, identical thunks are shared by content hash
+	class Region
+	{
+	public:
+		static constexpr std::size_t SLAB_MIN = 0x10;
+		static constexpr std::size_t SLAB_MAX = 0x1000;
+		static constexpr std::size_t SLAB_CLASSES = static_cast<std::size_t>(std::countr_zero(SLAB_MAX) - std::countr_zero(SLAB_MIN)) + 1;
+
+		Region(std::byte* a_data, std::size_t a_capacity) noexcept :
+			_data(a_data), _capacity(a_capacity)
+		{}
+
+		/** \brief Allocate a block from this region.
+		 * \return std::byte* : nullptr if the region is exhausted.
+		 */
+		[[nodiscard]] std::byte* allocate(std::size_t a_size) noexcept
+		{
+			// head of unallocated space, kept for incremental writes
+			if (!a_size) {
+				return _data + _used;
+			}
+
+			const auto size = block_size(a_size);
+			std::byte* mem = nullptr;
+
+			if (const auto index = size_class(size); index < SLAB_CLASSES && _free[index]) {
+				mem = std::exchange(_free[index], *std::bit_cast<std::byte**>(_free[index]));
+				_idle -= size;
+			} else if (auto it = std::ranges::find_if(_large, [size](auto& a_block) { return a_block.second >= size; }); it != _large.end()) {
+				const auto [block, blockSize] = *it;
+				_large.erase(it);
+				if (blockSize > size) {
+					_large.emplace_back(block + size, blockSize - size);
+				}
+
+				mem = block;
+				_idle -= size;
+			} else if (size <= free_size()) {
+				mem = _data + _used;
+				_used += size;
+			} else {
+				return nullptr;
+			}
+
+			_blocks.emplace(mem, a_size);
+			_live += a_size;
+
+			return mem;
+		}
+
+		void deallocate(std::byte* a_mem, std::size_t a_size) noexcept
+		{
+			// shared thunk is freed with its last reference
+			if (const auto ref = _refs.find(a_mem); ref != _refs.end()) {
+				auto& [hash, count] = ref->second;
+				if (--count) {
+					_shared -= a_size;
+					return;
+				}
+
+				auto [it, end] = _interned.equal_range(hash);
+				_interned.erase(std::find_if(it, end, [a_mem](auto& a_entry) { return a_entry.second == a_mem; }));
+				_refs.erase(ref);
+			}
+
+			const auto it = _blocks.find(a_mem);
+			dku_assert(it != _blocks.end() && it->second == a_size,
+				"DKU_H: Trampoline cannot free a block it did not allocate\n"
+				"block : {:X}\nsize  : {}",
+				AsAddress(a_mem), a_size);
+			_blocks.erase(it);
+			_live -= a_size;
+
+			const auto size = block_size(a_size);
+			if (const auto index = size_class(size); index < SLAB_CLASSES) {
+				*std::bit_cast<std::byte**>(a_mem) = _free[index];
+				_free[index] = a_mem;
+			} else {
+				_large.emplace_back(a_mem, size);
+			}
+			_idle += size;
+		}
+
+		/** \brief Take a reference to an interned block with identical content.
+		 * \return std::byte* : nullptr if no such block is interned in this region.
+		 */
+		[[nodiscard]] std::byte* find_shared(const void* a_data, std::size_t a_size) noexcept
+		{
+			for (auto [it, end] = _interned.equal_range(detail::hash(a_data, a_size)); it != end; ++it) {
+				auto* mem = it->second;
+				if (_blocks.find(mem)->second == a_size && !std::memcmp(mem, a_data, a_size)) {
+					++_refs.find(mem)->second.second;
+					_shared += a_size;
+					return mem;
+				}
+			}
+
+			return nullptr;
+		}
+
+		// register a written block for sharing, it holds the first reference
+		void share(std::byte* a_mem, std::size_t a_size) noexcept
+		{
+			const auto hash = detail::hash(a_mem, a_size);
+			_interned.emplace(hash, a_mem);
+			_refs.emplace(a_mem, std::make_pair(hash, static_cast<std::size_t>(1)));
+		}
+
+		[[nodiscard]] bool owns(const void* a_mem) const noexcept
+		{
+			const auto* mem = static_cast<const std::byte*>(a_mem);
+			return mem >= _data && mem < _data + _used;
+		}
+
+		// whole region is within rel32 reach of an address
+		[[nodiscard]] bool reaches(std::uintptr_t a_address) const noexcept
+		{
+			return detail::distance(AsAddress(_data), a_address) <= REACH &&
+			       detail::distance(AsAddress(_data + _capacity), a_address) <= REACH;
+		}
+
+		[[nodiscard]] constexpr std::byte*  data() const noexcept { return _data; }
+		[[nodiscard]] constexpr std::size_t capacity() const noexcept { return _capacity; }
+		[[nodiscard]] constexpr std::size_t consumed() const noexcept { return _used; }
+		[[nodiscard]] constexpr std::size_t free_size() const noexcept { return _capacity - _used; }
+		[[nodiscard]] constexpr std::size_t live() const noexcept { return _live; }
+		[[nodiscard]] constexpr std::size_t idle() const noexcept { return _idle; }
+		[[nodiscard]] constexpr std::size_t shared() const noexcept { return _shared; }
+
+		[[nodiscard]] const std::map<std::byte*, std::size_t>& blocks() const noexcept { return _blocks; }
+
+	private:
+		[[nodiscard]] static constexpr std::size_t block_size(std::size_t a_size) noexcept
+		{
+			return a_size <= SLAB_MAX ? std::bit_ceil((std::max)(a_size, SLAB_MIN)) : numbers::roundup(a_size, SLAB_MIN);
+		}
+
+		[[nodiscard]] static constexpr std::size_t size_class(std::size_t a_blockSize) noexcept
+		{
+			return a_blockSize <= SLAB_MAX ? static_cast<std::size_t>(std::countr_zero(a_blockSize) - std::countr_zero(SLAB_MIN)) : SLAB_CLASSES;
+		}
+
+		std::byte*                                                            _data{ nullptr };
+		std::size_t                                                           _capacity{ 0 };
+		std::size_t                                                           _used{ 0 };
+		std::size_t                                                           _live{ 0 };
+		std::size_t                                                           _idle{ 0 };
+		std::size_t                                                           _shared{ 0 };
+		std::array<std::byte*, SLAB_CLASSES>                                  _free{};
+		std::vector<std::pair<std::byte*, std::size_t>>                       _large;
+		std::map<std::byte*, std::size_t>                                     _blocks;
+		std::unordered_multimap<std::uint64_t, std::byte*>                    _interned;
+		std::unordered_map<std::byte*, std::pair<std::uint64_t, std::size_t>> _refs;
+	};
 
-			} while (min < max);
+	// partially taken from CommonLibSSE
+	// pool of regions, one is lazily reserved near each hook site that no existing region can reach
+	class Trampoline : public model::Singleton<Trampoline>
+	{
+	public:
+		static constexpr std::size_t SLAB_MIN = Region::SLAB_MIN;
+		static constexpr std::size_t SLAB_MAX = Region::SLAB_MAX;
 
-			if (!_data || !_capacity) {
-				release();
-				FATAL("DKU_H: PageAlloc failed with code: 0x{:08X}"sv, ::GetLastError());
+		/** \brief Reserve the first region and enable the pool, later regions are reserved with the same size.
+		 * \param a_size : size of each region.
+		 * \param a_from : address the first region must be reachable from, default to the end of module textx section.
+		 */
+		std::byte* PageAlloc(const std::size_t a_size, std::uintptr_t a_from = 0) noexcept
+		{
+			release();
+
+			if (!a_from) {
+				const auto textx = Module::get().section(Module::Section::textx);
+				a_from = textx.first + textx.second;
 			}
 
-			return _data;
+			_regionSize = a_size;
+			return add_region(a_size, a_from).data();
 		}
 
+		// use caller provided memory as a region, it must be executable and writable
 		void set_trampoline(void* a_mem, std::size_t a_size)
 		{
 			release();
 
-			_data = static_cast<std::byte*>(a_mem);
-			_capacity = a_size;
+			_regions.emplace_back(static_cast<std::byte*>(a_mem), a_size);
 		}
 
 		[[nodiscard]] void* allocate(std::size_t a_size)
 		{
-			auto result = do_allocate(a_size);
+			return allocate(a_size, 0);
+		}
+
+		/** \brief Allocate from the region nearest to a hook site, a new region is reserved if none can reach it.
+		 * \param a_size : size of block.
+		 * \param a_near : hook site the block must be reachable from with rel32, 0 for any region.
+		 */
+		[[nodiscard]] void* allocate(std::size_t a_size, std::uintptr_t a_near)
+		{
+			for (auto* region : reachable(a_near)) {
+				if (auto* mem = region->allocate(a_size)) {
+					log_stats();
+					return mem;
+				}
+			}
+
+			if (!_regionSize) {
+				FATAL("Failed to handle allocation request");
+			}
+
+			if (!a_near) {
+				const auto textx = Module::get().section(Module::Section::textx);
+				a_near = textx.first + textx.second;
+			}
+
+			auto* mem = add_region((std::max)(_regionSize, a_size), a_near).allocate(a_size);
 			log_stats();
-			return result;
+			return mem;
 		}
 
 		template <class T>
@@ -82,40 +344,145 @@ namespace DKUtil::Hook::Trampoline
 			return static_cast<T*>(allocate(sizeof(T)));
 		}
 
-		constexpr void release() noexcept
+		/** \brief Place a position independent thunk, an identical thunk already reachable from the hook site is reused.
+		 * \brief Interned blocks are reference counted by deallocate and must not be written after.
+		 * \param a_data : thunk bytes.
+		 * \param a_size : size of thunk.
+		 * \param a_near : hook site the thunk must be reachable from with rel32, 0 for any region.
+		 */
+		[[nodiscard]] void* intern(const void* a_data, std::size_t a_size, std::uintptr_t a_near = 0)
 		{
-			_data = nullptr;
-			_capacity = 0;
-			_used = 0;
+			for (auto* region : reachable(a_near)) {
+				if (auto* mem = region->find_shared(a_data, a_size)) {
+					__DEBUG("DKU_H: Trampoline shared {}B thunk @ {:X}", a_size, AsAddress(mem));
+					return mem;
+				}
+			}
+
+			auto* mem = static_cast<std::byte*>(allocate(a_size, a_near));
+			std::memcpy(mem, a_data, a_size);
+
+			for (auto& region : _regions) {
+				if (region.owns(mem)) {
+					region.share(mem, a_size);
+					break;
+				}
+			}
+
+			return mem;
 		}
 
-		[[nodiscard]] constexpr bool        empty() const noexcept { return _capacity == 0; }
-		[[nodiscard]] constexpr std::size_t capacity() const noexcept { return _capacity; }
-		[[nodiscard]] constexpr std::size_t consumed() const noexcept { return _used; }
-		[[nodiscard]] constexpr std::size_t free_size() const noexcept { return _capacity - _used; }
+		/** \brief Return a block to its size class free list, it's reused by later allocations of the same class.
+		 * \brief Interned blocks are returned with their last reference.
+		 * \param a_mem : block returned by allocate
+		 * \param a_size : size requested for the block
+		 */
+		void deallocate(void* a_mem, std::size_t a_size) noexcept
+		{
+			if (!a_size) {
+				return;
+			}
+
+			for (auto& region : _regions) {
+				if (region.owns(a_mem)) {
+					region.deallocate(static_cast<std::byte*>(a_mem), a_size);
+					log_stats();
+					return;
+				}
+			}
+		}
+
+		// regions are forgotten, not freed, hooks may still branch into them
+		void release() noexcept
+		{
+			_regions.clear();
+			_regionSize = 0;
+		}
+
+		[[nodiscard]] bool owns(const void* a_mem) const noexcept
+		{
+			return std::ranges::any_of(_regions, [a_mem](auto& a_region) { return a_region.owns(a_mem); });
+		}
+
+		[[nodiscard]] bool        empty() const noexcept { return _regions.empty(); }
+		[[nodiscard]] std::size_t capacity() const noexcept { return sum(&Region::capacity); }
+		[[nodiscard]] std::size_t consumed() const noexcept { return sum(&Region::consumed); }
+		[[nodiscard]] std::size_t free_size() const noexcept { return sum(&Region::free_size); }
+		// bytes requested by live blocks
+		[[nodiscard]] std::size_t live() const noexcept { return sum(&Region::live); }
+		// bytes held in free lists
+		[[nodiscard]] std::size_t idle() const noexcept { return sum(&Region::idle); }
+		// bytes saved by thunks shared with an identical one
+		[[nodiscard]] std::size_t shared() const noexcept { return sum(&Region::shared); }
+
+		// share of consumed bytes not requested by a live block, size class rounding and free lists
+		[[nodiscard]] double fragmentation() const noexcept
+		{
+			const auto used = consumed();
+			return used ? 1.0 - static_cast<double>(live()) / static_cast<double>(used) : 0.0;
+		}
+
+		// live blocks of all regions and their requested size
+		[[nodiscard]] std::map<std::byte*, std::size_t> blocks() const noexcept
+		{
+			std::map<std::byte*, std::size_t> blocks;
+			for (auto& region : _regions) {
+				blocks.insert(region.blocks().begin(), region.blocks().end());
+			}
+
+			return blocks;
+		}
+
+		[[nodiscard]] const std::deque<Region>& regions() const noexcept { return _regions; }
 
 	private:
-		[[nodiscard]] void* do_allocate(std::size_t a_size)
+		// regions within reach of an address, nearest first
+		[[nodiscard]] std::vector<Region*> reachable(std::uintptr_t a_near) noexcept
 		{
-			if (a_size > free_size()) {
-				FATAL("Failed to handle allocation request");
+			std::vector<Region*> regions;
+			for (auto& region : _regions) {
+				if (!a_near || region.reaches(a_near)) {
+					regions.push_back(std::addressof(region));
+				}
 			}
 
-			auto mem = _data + _used;
-			_used += a_size;
+			if (a_near) {
+				std::ranges::sort(regions, {}, [a_near](auto* a_region) { return detail::distance(AsAddress(a_region->data()), a_near); });
+			}
 
-			return mem;
+			return regions;
+		}
+
+		Region& add_region(std::size_t a_size, std::uintptr_t a_from) noexcept
+		{
+			auto* data = detail::reserve_near(a_size, a_from);
+			if (!data) {
+				FATAL("DKU_H: PageAlloc failed to reserve {}B near {:X}", a_size, a_from);
+			}
+
+			__DEBUG("DKU_H: Trampoline region {} @ {:X} | {}B near {:X}", _regions.size(), AsAddress(data), a_size, a_from);
+			return _regions.emplace_back(data, numbers::roundup(a_size, detail::granularity()));
+		}
+
+		[[nodiscard]] std::size_t sum(std::size_t (Region::*a_stat)() const noexcept) const noexcept
+		{
+			std::size_t total = 0;
+			for (auto& region : _regions) {
+				total += (region.*a_stat)();
+			}
+
+			return total;
 		}
 
 		void log_stats() const noexcept
 		{
-			auto pct = (static_cast<double>(_used) / static_cast<double>(_capacity)) * 100.0;
-			__DEBUG("Trampoline => {}B / {}B ({:05.2f}%)", _used, _capacity, pct);
+			auto pct = (static_cast<double>(consumed()) / static_cast<double>(capacity())) * 100.0;
+			__DEBUG("Trampoline => {}B / {}B ({:05.2f}%) in {} regions | live {}B in {} blocks | shared {}B | fragmentation {:05.2f}%", consumed(), capacity(), pct, _regions.size(), live(), blocks().size(), shared(), fragmentation() * 100.0);
 		}
 
-		std::byte*  _data{ nullptr };
-		std::size_t _capacity{ 0 };
-		std::size_t _used{ 0 };
+		// deque keeps region addresses stable while regions are added
+		std::deque<Region> _regions;
+		std::size_t        _regionSize{ 0 };
 	};
 
 	inline Trampoline& GetTrampoline() noexcept
@@ -138,4 +505,22 @@ namespace DKUtil::Hook::Trampoline
 		auto& trampoline = GetTrampoline();
 		return trampoline.allocate(a_size);
 	}
+
+	inline void* Allocate(std::size_t a_size, std::uintptr_t a_near)
+	{
+		auto& trampoline = GetTrampoline();
+		return trampoline.allocate(a_size, a_near);
+	}
+
+	inline void* Intern(const void* a_data, std::size_t a_size, std::uintptr_t a_near)
+	{
+		auto& trampoline = GetTrampoline();
+		return trampoline.intern(a_data, a_size, a_near);
+	}
+
+	inline void Deallocate(void* a_mem, std::size_t a_size)
+	{
+		auto& trampoline = GetTrampoline();
+		trampoline.deallocate(a_mem, a_size);
+	}
 }  // namespace DKUtil::Hook
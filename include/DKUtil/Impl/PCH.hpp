@@ -100,52 +100,54 @@
 using namespace std::literals;
 
 // winnt
-#define WIN32_LEAN_AND_MEAN
+#if defined(_WIN32)
+#	define WIN32_LEAN_AND_MEAN
 
-#define NOGDICAPMASKS
-#define NOVIRTUALKEYCODES
-//#define NOWINMESSAGES
-#define NOWINSTYLES
-#define NOSYSMETRICS
-#define NOMENUS
-#define NOICONS
-#define NOKEYSTATES
-#define NOSYSCOMMANDS
-#define NORASTEROPS
-#define NOSHOWWINDOW
-#define OEMRESOURCE
-#define NOATOM
-#define NOCLIPBOARD
-#define NOCOLOR
-//#define NOCTLMGR
-#define NODRAWTEXT
-#define NOGDI
-#define NOKERNEL
-//#define NOUSER
-#define NONLS
-//#define NOMB
-#define NOMEMMGR
-#define NOMETAFILE
-#define NOMINMAX
-//#define NOMSG
-#define NOOPENFILE
-#define NOSCROLL
-#define NOSERVICE
-#define NOSOUND
-#define NOTEXTMETRIC
-#define NOWH
-#define NOWINOFFSETS
-#define NOCOMM
-#define NOKANJI
-#define NOHELP
-#define NOPROFILER
-#define NODEFERWINDOWPOS
-#define NOMCX
-#include <Psapi.h>
-#include <ShlObj.h>
+#	define NOGDICAPMASKS
+#	define NOVIRTUALKEYCODES
+//#	define NOWINMESSAGES
+#	define NOWINSTYLES
+#	define NOSYSMETRICS
+#	define NOMENUS
+#	define NOICONS
+#	define NOKEYSTATES
+#	define NOSYSCOMMANDS
+#	define NORASTEROPS
+#	define NOSHOWWINDOW
+#	define OEMRESOURCE
+#	define NOATOM
+#	define NOCLIPBOARD
+#	define NOCOLOR
+//#	define NOCTLMGR
+#	define NODRAWTEXT
+#	define NOGDI
+#	define NOKERNEL
+//#	define NOUSER
+#	define NONLS
+//#	define NOMB
+#	define NOMEMMGR
+#	define NOMETAFILE
+#	define NOMINMAX
+//#	define NOMSG
+#	define NOOPENFILE
+#	define NOSCROLL
+#	define NOSERVICE
+#	define NOSOUND
+#	define NOTEXTMETRIC
+#	define NOWH
+#	define NOWINOFFSETS
+#	define NOCOMM
+#	define NOKANJI
+#	define NOHELP
+#	define NOPROFILER
+#	define NODEFERWINDOWPOS
+#	define NOMCX
+#	include <Psapi.h>
+#	include <ShlObj.h>
 
-#undef min
-#undef max
+#	undef min
+#	undef max
+#endif
 
 namespace DKUtil
 {};
@@ -232,6 +232,7 @@ namespace DKUtil::string
 
 	[[nodiscard]] inline auto utf8_to_utf16(std::string_view a_in) noexcept -> std::optional<std::wstring>
 	{
+#if defined(_WIN32)
 		const auto cvt = [&](wchar_t* a_dst, std::size_t a_length) {
 			return ::MultiByteToWideChar(
 				CP_UTF8, 0, a_in.data(), static_cast<int>(a_in.length()), a_dst, static_cast<int>(a_length));
@@ -248,10 +249,37 @@ namespace DKUtil::string
 		}
 
 		return out;
+#else
+		// wchar_t holds utf-32 outside of windows
+		std::wstring out;
+		for (std::size_t i = 0; i < a_in.size();) {
+			const auto lead = static_cast<std::uint8_t>(a_in[i]);
+			const auto length = lead < 0x80 ? 1 : static_cast<std::size_t>(std::countl_one(lead));
+			if ((lead >= 0x80 && (length < 2 || length > 4)) || i + length > a_in.size()) {
+				return std::nullopt;
+			}
+
+			char32_t code = length == 1 ? lead : lead & (0x7F >> length);
+			for (std::size_t j = 1; j < length; ++j) {
+				const auto trail = static_cast<std::uint8_t>(a_in[i + j]);
+				if ((trail >> 6) != 0x2) {
+					return std::nullopt;
+				}
+
+				code = code << 6 | (trail & 0x3F);
+			}
+
+			out.push_back(static_cast<wchar_t>(code));
+			i += length;
+		}
+
+		return out;
+#endif
 	}
 
 	[[nodiscard]] inline auto utf16_to_utf8(std::wstring_view a_in) noexcept -> std::optional<std::string>
 	{
+#if defined(_WIN32)
 		const auto cvt = [&](char* a_dst, std::size_t a_length) {
 			return ::WideCharToMultiByte(
 				CP_UTF8, 0, a_in.data(), static_cast<int>(a_in.length()), a_dst, static_cast<int>(a_length), nullptr, nullptr);
@@ -268,6 +296,31 @@ namespace DKUtil::string
 		}
 
 		return out;
+#else
+		std::string out;
+		for (const auto c : a_in) {
+			const auto code = static_cast<char32_t>(c);
+			if (code < 0x80) {
+				out.push_back(static_cast<char>(code));
+			} else if (code < 0x800) {
+				out.push_back(static_cast<char>(0xC0 | code >> 6));
+				out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+			} else if (code < 0x10000) {
+				out.push_back(static_cast<char>(0xE0 | code >> 12));
+				out.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+			} else if (code < 0x110000) {
+				out.push_back(static_cast<char>(0xF0 | code >> 18));
+				out.push_back(static_cast<char>(0x80 | (code >> 12 & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+			} else {
+				return std::nullopt;
+			}
+		}
+
+		return out;
+#endif
 	}
 
 	inline void set_char_buffer(std::string_view a_src, std::span<char> a_dst) noexcept
@@ -30,7 +30,7 @@
  *
  */
 
-#include "Impl/pch.hpp"
+#include "Impl/PCH.hpp"
 
 #define DKU_L_VERSION_MAJOR 1
 #define DKU_L_VERSION_MINOR 2
@@ -143,11 +143,16 @@ namespace DKUtil::Logger
 		// From CommonLibSSE https://github.com/Ryan-rsm-McKenzie/CommonLibSSE
 		inline std::filesystem::path docs_directory() noexcept
 		{
+#if defined(_WIN32)
 			wchar_t*                                               buffer{ nullptr };
 			const auto                                             result = ::SHGetKnownFolderPath(FOLDERID_Documents, KF_FLAG_DEFAULT, nullptr, std::addressof(buffer));
 			std::unique_ptr<wchar_t[], decltype(&::CoTaskMemFree)> knownPath{ buffer, ::CoTaskMemFree };
 
 			return (!knownPath || result != S_OK) ? std::filesystem::path{} : std::filesystem::path{ knownPath.get() };
+#else
+			const auto* home = std::getenv("HOME");
+			return home ? std::filesystem::path{ home } / "Documents" : std::filesystem::path{};
+#endif
 		}
 
 		inline spdlog::source_loc make_current(std::source_location a_loc) noexcept
@@ -157,6 +162,7 @@ namespace DKUtil::Logger
 
 		inline void report_error(bool a_fatal, std::string_view a_fmt)  // noexcept
 		{
+#if defined(_WIN32)
 			if (a_fatal) {
 				::MessageBoxA(nullptr, a_fmt.data(), Plugin::NAME.data(), MB_OK | MB_ICONSTOP);
 			} else {
@@ -167,13 +173,20 @@ namespace DKUtil::Logger
 			}
 
 			::TerminateProcess(::GetCurrentProcess(), 'FAIL');
+#else
+			// no prompt without a desktop, errors continue and fatal errors exit
+			std::fputs(a_fmt.data(), stderr);
+			if (a_fatal) {
+				std::_Exit(EXIT_FAILURE);
+			}
+#endif
 		}
 
 		inline constexpr const char* short_file(const char* path)
 		{
 			const char* file = path;
 			while (*path) {
-				if (*path++ == '\\') {
+				if (const auto c = *path++; c == '\\' || c == '/') {
 					file = path;
 				}
 			}
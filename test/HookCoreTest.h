@@ -0,0 +1,306 @@
+#pragma once
+
+#include "DKUtil/Hook.hpp"
+
+// hook tests that need no game process, run by the plugin and by the standalone test target
+namespace Test::Hook
+{
+	using namespace DKUtil::Alias;
+	using namespace dku::Hook::Assembly;
+
+#define PACK_BIG_ENDIAN(lo1, lo2, hi1, hi2) ((((lo1)&0xFF) << 0) | (((lo2)&0xFF) << 8) | (((hi1)&0xFF) << 16) | ((hi2)&0xFF) << 24)
+	void TestDispHelpers()
+	{
+		// clang-format off
+		constexpr OpCode asmBuf[] = { 0x8C, 0x05, 0x78, 0x56, 0x34, 0x12, };
+		// clang-format on
+
+		auto rip = &asmBuf[0];
+		INFO("rip {:X}", AsAddress(rip));
+		INFO("Op : 0x{:2X}", rip[0]);
+		auto dst = dku::Hook::GetDisp(rip);
+		INFO("dst : 0x{:X}", dst);
+		auto disp = dst - AsAddress(rip) - sizeof(asmBuf);
+		INFO("disp : 0x{:X}", disp);
+
+		auto offset = sizeof(asmBuf) - sizeof(Disp32);
+		auto packed = PACK_BIG_ENDIAN(asmBuf[offset + 0], asmBuf[offset + 1], asmBuf[offset + 2], asmBuf[offset + 3]);
+		dku_assert(packed == disp,
+			"incorrect");
+
+		namespace disasm = DKUtil::Hook::Disasm;
+		using Kind = disasm::Displacement::Kind;
+
+		struct Golden
+		{
+			std::array<OpCode, disasm::MAX_LENGTH> bytes;
+			std::size_t                            length;
+			std::ptrdiff_t                         target;
+			std::uint8_t                           offset;
+			Kind                                   kind;
+		};
+
+		// clang-format off
+		static constexpr Golden corpus[] = {
+			{ { 0xE8, 0x10, 0x00, 0x00, 0x00 }, 5, 0x15, 1, Kind::kCall },                                          // call rel32
+			{ { 0xEB, 0xFE }, 2, 0x0, 1, Kind::kJump },                                                            // jmp $
+			{ { 0x0F, 0x84, 0x10, 0x00, 0x00, 0x00 }, 6, 0x16, 2, Kind::kBranch },                                 // je rel32
+			{ { 0x48, 0x8B, 0x05, 0x30, 0x00, 0x00, 0x00 }, 7, 0x37, 3, Kind::kMemory },                           // mov rax, [rip+0x30]
+			{ { 0x80, 0x3D, 0x00, 0x01, 0x00, 0x00, 0x01 }, 7, 0x107, 2, Kind::kMemory },                          // cmp byte [rip+0x100], 1
+			{ { 0x81, 0x3D, 0x40, 0x00, 0x00, 0x00, 0x78, 0x56, 0x34, 0x12 }, 10, 0x4A, 2, Kind::kMemory },        // cmp dword [rip+0x40], imm32
+			{ { 0xF3, 0x0F, 0x10, 0x05, 0x10, 0x00, 0x00, 0x00 }, 8, 0x18, 4, Kind::kMemory },                     // movss xmm0, [rip+0x10]
+			{ { 0xC5, 0xFB, 0x10, 0x0D, 0x20, 0x00, 0x00, 0x00 }, 8, 0x28, 4, Kind::kMemory },                     // vmovsd xmm1, [rip+0x20]
+			{ { 0x62, 0xF1, 0x75, 0x48, 0xFE, 0x15, 0x80, 0x00, 0x00, 0x00 }, 10, 0x8A, 6, Kind::kMemory },        // vpaddd zmm2, zmm1, [rip+0x80]
+			{ { 0xFF, 0x15, 0x00, 0x00, 0x00, 0x00 }, 6, 0x6, 2, Kind::kCall },                                    // call [rip]
+		};
+		// clang-format on
+
+		for (auto& [bytes, length, target, offset, kind] : corpus) {
+			const auto disp = dku::Hook::DecodeDisp(bytes.data());
+			dku_assert(disp.length == length && disp.offset == offset && disp.kind == kind &&
+						   disp.target == AsAddress(bytes.data()) + target,
+				"decode disp incorrect\nread-in : 0x{:2X}", bytes[0]);
+		}
+
+		static_assert(disasm::displacement(corpus[4].bytes.data(), 0x1000).target == 0x1107);
+		static_assert(!disasm::displacement(std::array<OpCode, 3>{ 0x48, 0x89, 0xC8 }.data(), 0x1000));
+
+		std::array<std::uintptr_t, 3> callsites{ AsAddress(corpus[0].bytes.data()), AsAddress(corpus[2].bytes.data()), AsAddress(corpus[3].bytes.data()) };
+		const auto                    disps = dku::Hook::DecodeDisp(callsites);
+		dku_assert(disps.size() == 3 && disps[1].kind == Kind::kBranch && disps[2].target == callsites[2] + 0x37,
+			"decode disp batch incorrect");
+
+		// prefixed instructions resolve against the full instruction length
+		dku_assert(dku::Hook::GetDisp(corpus[3].bytes.data()) == AsAddress(corpus[3].bytes.data()) + 0x37,
+			"get disp incorrect");
+	}
+
+	void TestDisasm()
+	{
+		namespace disasm = DKUtil::Hook::Disasm;
+
+		struct Golden
+		{
+			std::array<OpCode, disasm::MAX_LENGTH> bytes;
+			std::size_t                            length;
+		};
+
+		// clang-format off
+		constexpr Golden corpus[] = {
+			{ { 0x90 }, 1 },                                                              // nop
+			{ { 0xC3 }, 1 },                                                              // ret
+			{ { 0x57 }, 1 },                                                              // push rdi
+			{ { 0x48, 0x89, 0x5C, 0x24, 0x08 }, 5 },                                      // mov [rsp+8], rbx
+			{ { 0x48, 0x83, 0xEC, 0x20 }, 4 },                                            // sub rsp, 0x20
+			{ { 0x48, 0x81, 0xEC, 0x00, 0x01, 0x00, 0x00 }, 7 },                          // sub rsp, 0x100
+			{ { 0x48, 0x8B, 0x0D, 0x78, 0x56, 0x34, 0x12 }, 7 },                          // mov rcx, [rip+0x12345678]
+			{ { 0x66, 0x0F, 0x1F, 0x44, 0x00, 0x00 }, 6 },                                // nop word [rax+rax]
+			{ { 0x0F, 0x1F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 }, 8 },                    // nop dword [rax+rax+0]
+			{ { 0xE8, 0x12, 0x34, 0x56, 0x78 }, 5 },                                      // call rel32
+			{ { 0xEB, 0x10 }, 2 },                                                        // jmp rel8
+			{ { 0x0F, 0x84, 0x12, 0x34, 0x56, 0x78 }, 6 },                                // je rel32
+			{ { 0xFF, 0x15, 0x12, 0x34, 0x56, 0x78 }, 6 },                                // call [rip+disp32]
+			{ { 0x48, 0xB8, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 }, 10 },       // mov rax, imm64
+			{ { 0x48, 0xA1, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 }, 10 },       // mov rax, moffs64
+			{ { 0x66, 0xF7, 0x00, 0x34, 0x12 }, 5 },                                      // test word [rax], 0x1234
+			{ { 0xF6, 0x05, 0x10, 0x00, 0x00, 0x00, 0x01 }, 7 },                          // test byte [rip+0x10], 1
+			{ { 0xC7, 0x44, 0x24, 0x20, 0x01, 0x00, 0x00, 0x00 }, 8 },                    // mov dword [rsp+0x20], 1
+			{ { 0xF3, 0x0F, 0x10, 0x05, 0x12, 0x34, 0x56, 0x78 }, 8 },                    // movss xmm0, [rip+disp32]
+			{ { 0x66, 0x0F, 0x3A, 0x0F, 0xC1, 0x08 }, 6 },                                // palignr xmm0, xmm1, 8
+			{ { 0xC8, 0x10, 0x00, 0x00 }, 4 },                                            // enter 0x10, 0
+			{ { 0xC5, 0xF8, 0x77 }, 3 },                                                  // vzeroupper
+			{ { 0xC5, 0xFA, 0x10, 0x05, 0x12, 0x34, 0x56, 0x78 }, 8 },                    // vmovss xmm0, [rip+disp32]
+			{ { 0xC4, 0xE3, 0x61, 0x48, 0xE2, 0x11 }, 6 },                                // vpermil2ps xmm4, xmm3, xmm2, xmm1, 1
+			{ { 0x62, 0xF3, 0x75, 0x48, 0x25, 0x50, 0x01, 0xFF }, 8 },                    // vpternlogd zmm2, zmm1, [rax+0x40], 0xff
+			{ { 0x8F, 0xEA, 0x78, 0x10, 0xC8, 0x34, 0x12, 0x00, 0x00 }, 9 },              // bextr ecx, eax, 0x1234
+			{ { 0xF0, 0x48, 0x0F, 0xB1, 0x0D, 0x12, 0x34, 0x56, 0x78 }, 9 },              // lock cmpxchg [rip+disp32], rcx
+		};
+		// clang-format on
+
+		for (auto& [bytes, length] : corpus) {
+			dku_assert(disasm::decode(bytes.data()).length == length,
+				"decode length incorrect\nread-in : 0x{:2X}", bytes[0]);
+		}
+
+		static_assert(disasm::decode(std::array<OpCode, 2>{ 0xEB, 0xFE }.data(), 2).target(0x1000) == 0x1000);
+		static_assert(disasm::decode(std::array<OpCode, 4>{ 0x48, 0x8B, 0x0D, 0x00 }.data(), 4).length == 0);
+
+		// mov rax, [rip+0x10] ; je rel8 ; call rel32
+		constexpr OpCode   stolen[] = { 0x48, 0x8B, 0x05, 0x10, 0x00, 0x00, 0x00, 0x74, 0x05, 0xE8, 0x00, 0x00, 0x00, 0x00 };
+		constexpr Imm64    from = 0x140001000;
+		constexpr Imm64    near = 0x140101000;
+		constexpr Imm64    far = 0x7FF600000000;
+		const auto         relocated = disasm::relocate(stolen, sizeof(stolen), from, near);
+		dku_assert(relocated.size() == 18 &&
+					   disasm::decode(relocated.data()).target(near) == from + 0x17 &&
+					   disasm::decode(relocated.data() + 7).target(near + 7) == from + sizeof(stolen) &&
+					   disasm::decode(relocated.data() + 13).target(near + 13) == from + sizeof(stolen),
+			"relocate incorrect");
+		dku_assert(disasm::relocate(stolen, sizeof(stolen), from, far).empty(),
+			"relocate should fail on out of range rip operand");
+
+		// far branch becomes jmp [rip] ; dq target
+		constexpr OpCode jmp[] = { 0xEB, 0x00 };
+		const auto       absolute = disasm::relocate(jmp, sizeof(jmp), from, far);
+		Imm64            target = 0;
+		dku_assert(absolute.size() == 14 && absolute[0] == 0xFF && absolute[1] == 0x25,
+			"relocate absolute incorrect");
+		std::memcpy(&target, absolute.data() + 6, sizeof(target));
+		dku_assert(target == from + sizeof(jmp),
+			"relocate absolute target incorrect");
+
+		// jecxz keeps its address size prefix, dropping it would test all of rcx
+		constexpr OpCode jecxz[] = { 0x67, 0xE3, 0x05 };
+		const auto       counter = disasm::relocate(jecxz, sizeof(jecxz), from, near);
+		dku_assert(counter.size() == 10 && counter[0] == 0x67 && counter[1] == 0xE3 &&
+					   disasm::decode(counter.data() + 5).target(near + 5) == from + sizeof(jecxz) + 0x05 &&
+					   disasm::relocate_bound(jecxz, sizeof(jecxz)) == 19 &&
+					   disasm::relocate(jecxz, sizeof(jecxz), from, far).size() == 19,
+			"relocate prefixed jecxz incorrect");
+
+		constexpr OpCode prolog[] = { 0x48, 0x89, 0x5C, 0x24, 0x08, 0x57, 0x48, 0x83, 0xEC, 0x20 };
+		dku_assert(dku::Hook::AutoOffset(prolog) == dku::Hook::offset_pair(0, 5) &&
+					   dku::Hook::AutoOffset(prolog, 6) == dku::Hook::offset_pair(0, 6) &&
+					   dku::Hook::AutoOffset(prolog, 7) == dku::Hook::offset_pair(0, 10),
+			"auto offset incorrect");
+	}
+
+	namespace Latency
+	{
+		inline std::size_t    Hits{ 0 };
+		inline std::uintptr_t Vtbl[1]{};
+
+		int Callee()
+		{
+			return 1;
+		}
+
+		int Detour()
+		{
+			++Hits;
+			return 2;
+		}
+
+		void Probe()
+		{
+			++Hits;
+		}
+	}
+
+	// per call cost of each hook kind over an in-process call site, no game code involved
+	void TestHookLatency()
+	{
+		using site_t = int (*)();
+
+		constexpr std::size_t calls = static_cast<std::size_t>(1) << 20;
+
+#if defined(SKSEAPI)
+		SKSE::AllocTrampoline(static_cast<std::size_t>(1) << 10);
+#else
+		dku::Hook::Trampoline::AllocTrampoline(static_cast<std::size_t>(1) << 16);
+#endif
+
+		// sub rsp, 0x28 | mov eax, 1 | call Callee | add rsp, 0x28 | ret
+		OpCode                   code[] = { 0x48, 0x83, 0xEC, 0x28, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xE8, 0x00, 0x00, 0x00, 0x00, 0x48, 0x83, 0xC4, 0x28, 0xC3 };
+		constexpr std::ptrdiff_t movSite = 0x4;
+		constexpr std::ptrdiff_t callSite = 0x9;
+
+		const auto site = TRAM_ALLOC_NEAR(sizeof(code), AsAddress(&Latency::Callee));
+		AsMemCpy(code + callSite + 1, static_cast<Disp32>(AsAddress(&Latency::Callee) - (site + callSite + sizeof(JmpRel))));
+		std::memcpy(AsPointer(site), code, sizeof(code));
+
+		const auto call = [site]() { return std::bit_cast<site_t>(site)(); };
+		const auto vcall = []() { return std::bit_cast<site_t>(std::atomic_ref{ Latency::Vtbl[0] }.load())(); };
+
+		auto bench = [](auto&& a_call) {
+			Latency::Hits = 0;
+			const auto start = std::chrono::steady_clock::now();
+			for (std::size_t i = 0; i < calls; ++i) {
+				a_call();
+			}
+			return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+		};
+
+		auto report = [](std::string_view a_kind, double a_base, double a_hooked, std::size_t a_hits) {
+			INFO("{} hook : {:.2f}ns -> {:.2f}ns per call | +{:.2f}ns", a_kind, a_base, a_hooked, a_hooked - a_base);
+			dku_assert(Latency::Hits == a_hits,
+				"{} hook did not run as expected\nhits : {}", a_kind, Latency::Hits);
+		};
+
+		const auto base = bench(call);
+
+		// call Callee -> call Detour
+		auto rel = dku::Hook::AddRelHook<5, true>(site + callSite, AsAddress(&Latency::Detour));
+		rel->Enable();
+		report("rel", base, bench(call), calls);
+		rel->Disable();
+
+		// mov eax, 1 -> Probe
+		auto cave = dku::Hook::AddCaveHook(site, { movSite, callSite }, FUNC_INFO(Latency::Probe));
+		cave->Enable();
+		report("cave", base, bench(call), calls);
+		cave->Disable();
+
+		// mov eax, 1 -> mov eax, 2 | nop, exceeds the site and runs in trampoline
+		constexpr OpCode patch[] = { 0xB8, 0x02, 0x00, 0x00, 0x00, 0x90 };
+		auto             asmPatch = dku::Hook::AddASMPatch(site, { movSite, callSite }, std::make_pair(patch, sizeof(patch)));
+		asmPatch->Enable();
+		report("asm", base, bench(call), 0);
+		asmPatch->Disable();
+
+		// vtbl[0] Callee -> Detour
+		Latency::Vtbl[0] = AsAddress(&Latency::Callee);
+		void*      object = Latency::Vtbl;
+		const auto vbase = bench(vcall);
+
+		auto vmt = dku::Hook::AddVMTHook(&object, 0, FUNC_INFO(Latency::Detour));
+		vmt->Enable();
+		report("vmt", vbase, bench(vcall), calls);
+		vmt->Disable();
+
+		dku_assert(call() == 1 && vcall() == 1,
+			"hooks not restored");
+	}
+
+#if !defined(_WIN32)
+	// a thread blocking the quiesce signal is skipped instead of failing every round
+	void TestInstallBatchBlocked()
+	{
+		const auto size = dku::Hook::Platform::page_size();
+		auto*      mem = static_cast<OpCode*>(::mmap(nullptr, size, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+		std::atomic_bool   running{ true };
+		std::atomic_size_t spins{ 0 };
+		std::jthread       worker{ [&] {
+			while (running) {
+				++spins;
+			}
+		} };
+		std::jthread       blocker{ [&] {
+			::sigset_t set;
+			::sigemptyset(&set);
+			::sigaddset(&set, dku::Hook::InstallBatch::quiesce_signal());
+			::pthread_sigmask(SIG_BLOCK, &set, nullptr);
+			while (running) {
+				std::this_thread::yield();
+			}
+		} };
+
+		const auto start = std::chrono::steady_clock::now();
+		for (std::uint64_t i = 1; i <= 0x10; ++i) {
+			dku::Hook::InstallBatch batch;
+			dku::Hook::WriteImm(AsAddress(mem) + 0x8, i);  // qword store
+		}
+
+		dku_assert(*dku::Hook::adjust_pointer<std::uint64_t>(mem, 0x8) == 0x10 && std::chrono::steady_clock::now() - start < 1s,
+			"install batch waited for a thread blocking the quiesce signal");
+
+		// worker is resumed after commit
+		const auto before = spins.load();
+		while (spins == before) {}
+		running = false;
+
+		::munmap(mem, size);
+	}
+#endif
+}
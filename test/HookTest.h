@@ -1,5 +1,7 @@
 #include "DKUtil/Hook.hpp"
 
+#include "HookCoreTest.h"
+
 namespace Test::Hook
 {
 	using namespace DKUtil::Alias;
@@ -214,6 +216,13 @@ namespace Test::Hook
 		static_assert(pattern::do_make_pattern<"B8 D0 ?? ?? D4 6E">().match(
 			pattern::make_byte_array(0xB8, 0xD0, 0x35, 0x2A, 0xD4, 0x6E)));
 
+		static constexpr auto hay = pattern::make_byte_array(0x90, 0xB8, 0xD0, 0x11, 0x22, 0xD4, 0x6E, 0xCC);
+		constexpr auto&       sp = pattern::static_pattern<"B8 D0 ?? ?? D4 6E">;
+		static_assert(sp.size() == 6 && sp.mask[2] == pattern::WILDCARD && sp.value[0] == std::byte{ 0xB8 });
+		static_assert(sp.match(pattern::make_byte_array(0xB8, 0xD0, 0x35, 0x2A, 0xD4, 0x6E)));
+		static_assert(sp.find(hay.data(), hay.data() + hay.size()) == &hay[1]);
+		static_assert(!pattern::static_pattern<"D46ECC90">.find(hay.data(), hay.data() + hay.size()));
+
 		std::string s{ "B8 0xD0 0xF52A D4 6E ?? 0x13141592" };
 		auto        buf = pattern::make_byte_array(0xB8, 0xD0, 0xF5, 0x2A, 0xD4, 0x6E, 0x77, 0x13, 0x14, 0x15, 0x92);
 		std::string pat{ " F5 ?? D4" };
@@ -227,6 +236,711 @@ namespace Test::Hook
 		auto* f = assembly::search_pattern(pat, buf.data(), buf.size());
 		dku_assert(f == &buf[2],
 			"search incorrect");
+		dku_assert(assembly::search_pattern<"F5 ?? D4">(AsAddress(buf.data()), buf.size()) == &buf[2],
+			"static pattern search incorrect");
+
+		auto repeated = pattern::make_byte_array(0xE8, 0x01, 0x02, 0xE8, 0x03, 0x04, 0xE8, 0x05, 0x06, 0xC3);
+		auto calls = assembly::search_all("E8 ?? ??", repeated.data(), repeated.size());
+		dku_assert(std::ranges::equal(calls, std::array{ &repeated[0], &repeated[3], &repeated[6] }),
+			"search all incorrect");
+		dku_assert(assembly::search_count("E8 ?? ??", repeated.data(), repeated.size()) == 3 &&
+					   assembly::search_count("E8 ?? ??", repeated.data(), repeated.size(), 2) == 2,
+			"search count incorrect");
+		dku_assert(!assembly::search_unique("E8 ?? ??", repeated.data(), repeated.size()) &&
+					   assembly::search_unique("E8 03", repeated.data(), repeated.size()) == &repeated[3],
+			"search unique incorrect");
+	}
+
+	void TestPatternBenchmark()
+	{
+		namespace assembly = DKUtil::Hook::Assembly;
+
+		constexpr std::size_t size = static_cast<std::size_t>(1) << 26;
+
+		// synthetic text section, biased towards common x64 opcodes
+		std::vector<std::byte> buf(size);
+		std::mt19937           rng{ 0x44'4B'55 };
+		constexpr OpCode       ops[] = { 0x48, 0x8B, 0x89, 0xCC, 0x0F, 0xE8, 0x4C, 0x24, 0x00, 0xFF };
+		for (auto& b : buf) {
+			b = std::byte{ rng() % 3 ? ops[rng() % std::extent_v<decltype(ops)>] : static_cast<OpCode>(rng()) };
+		}
+
+		constexpr OpCode planted[] = { 0x48, 0x8B, 0x0D, 0x11, 0x22, 0x33, 0x44, 0x48, 0x85, 0xC9, 0x74, 0x2E, 0xE8 };
+		std::memcpy(buf.data() + size - 0x1000, planted, sizeof(planted));
+
+		constexpr std::string_view patterns[] = {
+			"48 8B 0D ?? ?? ?? ?? 48 85 C9 74 2E E8",
+			"48 8B 0D 11 22 33 44",
+			"E8 ?? ?? ?? ?? 48 8B 0D ?? ?? ?? ?? 48 85 C9 74 2E",
+		};
+
+		for (auto pattern : patterns) {
+			auto timed = [&](auto&& a_search) {
+				const auto start = std::chrono::steady_clock::now();
+				auto*      result = a_search();
+				const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+				return std::make_pair(result, elapsed.count());
+			};
+
+			auto [kmp, kmpTime] = timed([&]() { return assembly::search_pattern_kmp(pattern, buf.data(), buf.size()); });
+			auto [simd, simdTime] = timed([&]() { return assembly::search_pattern(pattern, buf.data(), buf.size()); });
+			auto [par, parTime] = timed([&]() { return assembly::search_pattern(std::execution::par, pattern, buf.data(), buf.size()); });
+
+			INFO("{} : kmp {:.3f}ms | simd {:.3f}ms | x{:.1f} | parallel {:.3f}ms | x{:.1f}", pattern, kmpTime, simdTime, kmpTime / simdTime, parTime, kmpTime / parTime);
+			dku_assert(kmp == simd && simd == par,
+				"search mismatch");
+		}
+
+		// find all, every planted copy must be reported once and in order
+		for (std::size_t i = 0; i < 7; ++i) {
+			std::memcpy(buf.data() + i * (size / 8), planted, sizeof(planted));
+		}
+
+		auto all = assembly::search_all(std::execution::par, "48 8B 0D 11 22 33 44 48 85 C9 74 2E E8", buf.data(), buf.size());
+		dku_assert(all.size() == 8 && std::ranges::is_sorted(all),
+			"search all incorrect");
+	}
+
+	void TestPatternSet()
+	{
+		namespace assembly = DKUtil::Hook::Assembly;
+
+		auto buf = assembly::Pattern::make_byte_array(
+			0x48, 0x8B, 0x0D, 0x11, 0x22, 0x33, 0x44, 0xE8, 0x90, 0x90, 0x90, 0x90,
+			0x48, 0x85, 0xC9, 0x74, 0x2E, 0xCC, 0xC3, 0x40, 0x57, 0x48, 0x83, 0xEC);
+
+		assembly::PatternSet set{
+			"48 8B 0D ?? ?? ?? ??",
+			"E8 ?? ?? ?? ?? 48 85 C9",
+			"40 57 48 83 EC",
+			"74 ?? CC",
+			"FF FF FF",
+		};
+
+		auto matches = set.search(buf.data(), buf.size());
+		dku_assert(matches.size() == set.size(),
+			"match table size incorrect");
+		dku_assert(matches[0] == &buf[0] && matches[1] == &buf[7] && matches[2] == &buf[19] && matches[3] == &buf[15] && !matches[4],
+			"pattern set search incorrect");
+
+		for (std::size_t id = 0; id < matches.size(); ++id) {
+			INFO("pattern {} -> {:X}", id, AsAddress(matches[id]));
+		}
+	}
+
+	void TestSignatureCache()
+	{
+		namespace assembly = DKUtil::Hook::Assembly;
+
+		constexpr std::string_view patterns[] = {
+			"48 8B 0D ?? ?? ?? ?? 48 85 C9",
+			"40 57 48 83 EC ??",
+			"E8 ?? ?? ?? ?? 84 C0 74",
+		};
+
+		const auto path = std::filesystem::current_path() / "DKUtilDebugger.sigcache";
+		std::filesystem::remove(path);
+
+		assembly::PatternSet::match_table cold;
+		{
+			assembly::SignatureCache cache{ path };
+			cold = cache.resolve(patterns);
+			dku_assert(cache.hits() == 0,
+				"cold cache has hits");
+		}
+
+		assembly::SignatureCache cache{ path };
+		auto                     warm = cache.resolve(patterns);
+		dku_assert(warm == cold && cache.hits() == std::ranges::count_if(cold, [](auto* a_match) { return a_match != nullptr; }),
+			"warm cache incorrect");
+
+		for (std::size_t i = 0; i < std::extent_v<decltype(patterns)>; ++i) {
+			dku_assert(warm[i] == assembly::search_pattern(patterns[i]),
+				"cached rva mismatch");
+		}
+	}
+
+	// offline image of the running executable must agree with the loaded module
+	void TestPEImage()
+	{
+		auto&                module = dku::Hook::Module::get();
+		dku::Hook::PEImage image{ dku::Hook::GetModulePath() };
+
+		const auto [textx, size] = module.section(dku::Hook::Module::Section::textx);
+		const auto [rva, rawSize] = image.section_rva(dku::Hook::Module::Section::textx);
+		dku_assert(textx - module.base() == rva && rawSize <= size,
+			"offline textx mismatch\nmodule : {:X} | image : {:X}", textx - module.base(), rva);
+
+		dku_assert(image.rva(AsPointer(image.section(dku::Hook::Module::Section::textx).first)) == rva && image.offset(rva).has_value(),
+			"rva translation incorrect");
+
+		// game code can be patched by other plugins, the loaded match may only move if the bytes of the offline match changed
+		const auto* match = image.search_pattern("40 57 48 83 EC ??");
+		const auto* loaded = dku::Hook::Assembly::search_pattern("40 57 48 83 EC ??");
+		dku_assert(match && loaded, "offline or loaded pattern not found");
+
+		const auto matchRva = image.rva(match);
+		const bool patched = std::memcmp(AsPointer(module.base() + matchRva), match, 6) != 0;
+		dku_assert(matchRva >= rva && matchRva < rva + rawSize && (patched || AsAddress(loaded) - module.base() == matchRva),
+			"offline match mismatch\noffline : {:X} | loaded : {:X}", matchRva, AsAddress(loaded) - module.base());
+
+		if (auto* iat = dku::Hook::GetImportAddress({}, "kernel32.dll", "GetProcAddress")) {
+			dku_assert(image.GetImportAddress("kernel32.dll", "GetProcAddress") == AsAddress(iat) - module.base(),
+				"offline import address mismatch");
+		}
+	}
+
+	void TestSymbolIndex()
+	{
+		auto* iat = dku::Hook::GetImportAddress({}, "KERNEL32.DLL", "getprocaddress");
+		dku_assert(iat == dku::Hook::GetImportAddress({}, "kernel32.dll", "GetProcAddress"),
+			"import lookup is case sensitive");
+
+		// both are exported by kernel32 itself, not forwarded
+		const auto kernel32 = ::GetModuleHandleA("kernel32.dll");
+		for (auto name : { "VirtualAlloc", "CreateFileW" }) {
+			auto* address = dku::Hook::GetExportAddress("kernel32.dll", name);
+			dku_assert(address && address == ::GetProcAddress(kernel32, name),
+				"export address mismatch\nname : {}", name);
+		}
+
+		// lowest ordinals may be forwarded, which are not resolved
+		auto* byOrdinal = dku::Hook::GetExportAddress("kernel32.dll", dku::Hook::ExportOrdinal{ 1 });
+		dku_assert(!byOrdinal || byOrdinal == ::GetProcAddress(kernel32, MAKEINTRESOURCEA(1)),
+			"export ordinal mismatch");
+
+		dku_assert(!dku::Hook::GetExportAddress("kernel32.dll", "DKUtilNonExistentExport"),
+			"non existent export resolved");
+	}
+
+	void TestModuleRegistry()
+	{
+		auto&      game = dku::Hook::Module::get();
+		const auto [textx, size] = game.section(dku::Hook::Module::Section::textx);
+
+		dku_assert(dku::Hook::ModuleFor(textx + size / 2) == std::addressof(game) && std::addressof(dku::Hook::Module::get(textx + 1)) == std::addressof(game),
+			"address inside module not resolved to module");
+
+		auto* plugin = dku::Hook::ModuleFor(&TestModuleRegistry);
+		dku_assert(plugin && plugin != std::addressof(game) && dku::Hook::GetRva(AsAddress(&TestModuleRegistry)) == AsAddress(&TestModuleRegistry) - plugin->base(),
+			"plugin address not resolved to plugin module");
+
+		int local{ 0 };
+		dku_assert(!dku::Hook::ModuleFor(&local),
+			"stack address resolved to module");
+
+		std::atomic_size_t        resolved{ 0 };
+		std::vector<std::jthread> workers;
+		for (auto i = 0; i < 4; ++i) {
+			workers.emplace_back([&] {
+				for (auto n = 0; n < 0x10000; ++n) {
+					resolved += dku::Hook::ModuleFor(textx + n) == std::addressof(game);
+				}
+			});
+		}
+		workers.clear();
+
+		dku_assert(resolved == 4 * 0x10000,
+			"concurrent lookup incorrect");
+
+		INFO("{} loaded modules, plugin {} at {:X}", dku::Hook::ModuleRegistry::get().ranges().size(), plugin->name(), plugin->base());
+	}
+
+	namespace Unwind
+	{
+		inline std::size_t (*volatile Next)(std::size_t) = [](std::size_t a_value) { return a_value + 1; };
+
+		// calls out and keeps a stack frame, so it has unwind data in this module
+		std::size_t Frame(std::size_t a_value)
+		{
+			volatile std::size_t values[0x10]{};
+			for (auto& value : values) {
+				value = Next(a_value);
+			}
+
+			return values[0] + values[0xF];
+		}
+	}
+
+	// exports of system modules may be forwarding stubs without unwind data, the test module is built with it
+	void TestFunctionAt()
+	{
+		auto function = AsAddress(&Unwind::Frame);
+		// incremental linking takes function addresses through a jmp thunk
+		if (*std::bit_cast<const OpCode*>(function) == 0xE9) {
+			function = dku::Hook::GetDisp(function);
+		}
+
+		const auto range = dku::Hook::FunctionAt(function + 1);
+		dku_assert(range.begin == function && range.end > function + 1 && range.unwind && range.primary == function,
+			"function range incorrect\nfunction : {:X}\nbegin : {:X}", function, range.begin);
+		dku_assert(dku::Hook::GetFuncPrologAddr(range.end - 1) == range.primary && Unwind::Frame(1) == 4,
+			"prolog of function end incorrect");
+	}
+
+	namespace Shadow
+	{
+		struct Base
+		{
+			virtual ~Base() = default;
+			virtual int Get() { return 1; }
+		};
+
+		struct Derived : Base
+		{
+			int Get() override { return 2; }
+		};
+
+		int Get(Base*)
+		{
+			return 3;
+		}
+
+		// loaded through a volatile pointer, the dynamic type is unknown and the call cannot be devirtualized
+		int Call(Base* a_object)
+		{
+			Base* volatile object = a_object;
+			return object->Get();
+		}
+	}
+
+	void TestVMTShadow()
+	{
+		Shadow::Derived hooked;
+		Shadow::Derived other;
+		Shadow::Base*   object = std::addressof(hooked);
+
+		auto shadow = dku::Hook::AddVMTShadowHook(object, 1, FUNC_INFO(Shadow::Get));
+		shadow->Enable();
+
+		dku_assert(Shadow::Call(object) == 3 && Shadow::Call(std::addressof(other)) == 2 && dynamic_cast<Shadow::Derived*>(object) == std::addressof(hooked),
+			"shadow vtable not limited to hooked object");
+		dku_assert(shadow->GetOldFunction<int (*)(Shadow::Base*)>(1)(object) == 2,
+			"shadow original function incorrect");
+
+		// same vtable and overrides share the clone
+		auto second = dku::Hook::AddVMTShadowHook(std::addressof(other), 1, FUNC_INFO(Shadow::Get));
+		dku_assert(second->TramEntry == shadow->TramEntry,
+			"shadow vtable not shared");
+
+		shadow->Disable();
+		dku_assert(Shadow::Call(object) == 2,
+			"shadow vtable not restored");
+	}
+
+	namespace Chain
+	{
+		inline std::vector<int>                 Order;
+		inline std::uintptr_t                   Site{ 0 };
+		inline dku::Hook::HookChain::detour_t   Outer{};
+		inline dku::Hook::HookChain::detour_t   Inner{};
+
+		int Callee(int a_value)
+		{
+			Order.push_back(0);
+			return a_value;
+		}
+
+		void Observe(int a_value)
+		{
+			Order.push_back(100 + a_value);
+		}
+
+		void Count(int)
+		{
+			Order.push_back(200);
+		}
+
+		int Offset(int a_value)
+		{
+			Order.push_back(2);
+			return dku::Hook::HookChain::GetNext<int (*)(int)>(Outer)(a_value) + 1000;
+		}
+
+		int Double(int a_value)
+		{
+			Order.push_back(1);
+			return dku::Hook::HookChain::GetNext<int (*)(int)>(Inner)(a_value) * 2;
+		}
+	}
+
+	void TestHookChain()
+	{
+		using site_t = int (*)();
+
+#if defined(SKSEAPI)
+		SKSE::AllocTrampoline(static_cast<std::size_t>(1) << 10);
+#else
+		dku::Hook::Trampoline::AllocTrampoline(static_cast<std::size_t>(1) << 12);
+#endif
+
+		// sub rsp, 0x28 | mov ecx, 5 | call Callee | add rsp, 0x28 | ret
+		OpCode                   code[] = { 0x48, 0x83, 0xEC, 0x28, 0xB9, 0x05, 0x00, 0x00, 0x00, 0xE8, 0x00, 0x00, 0x00, 0x00, 0x48, 0x83, 0xC4, 0x28, 0xC3 };
+		constexpr std::ptrdiff_t callSite = 0x9;
+
+		const auto site = TRAM_ALLOC_NEAR(sizeof(code), AsAddress(&Chain::Callee));
+		AsMemCpy(code + callSite + 1, static_cast<Disp32>(AsAddress(&Chain::Callee) - (site + callSite + sizeof(JmpRel))));
+		std::memcpy(AsPointer(site), code, sizeof(code));
+
+		const auto call = [site]() {
+			Chain::Order.clear();
+			return std::bit_cast<site_t>(site)();
+		};
+
+		Chain::Site = site + callSite;
+		auto& chain = dku::Hook::HookChain::At(Chain::Site);
+
+		// observers first by priority, then Offset -> Double -> Callee
+		const auto count = chain.AddHandler(FUNC_INFO(Chain::Count), -1);
+		Chain::Inner = chain.AddDetour(FUNC_INFO(Chain::Double), 1);
+		Chain::Outer = chain.AddDetour(FUNC_INFO(Chain::Offset), 2);
+		const auto observe = chain.AddHandler(FUNC_INFO(Chain::Observe), 1);
+
+		dku_assert(call() == 1010 && Chain::Order == std::vector{ 105, 200, 2, 1, 0 },
+			"hook chain order incorrect");
+		dku_assert(dku::Hook::HookChain::Owns(site, sizeof(code)) && !dku::Hook::HookChain::Owns(site, callSite),
+			"hook chain site ownership incorrect");
+
+		// the next of Offset is relinked to Callee, a removed detour still running continues to its last next
+		chain.Remove(Chain::Inner);
+		dku_assert(call() == 1005 && Chain::Order == std::vector{ 105, 200, 2, 0 },
+			"hook chain not relinked");
+		dku_assert(dku::Hook::HookChain::GetNext<int (*)(int)>(Chain::Inner) == &Chain::Callee,
+			"hook chain retired detour lost its next");
+
+		chain.Remove(count);
+		chain.Remove(observe);
+		chain.Remove(Chain::Outer);
+		dku_assert(!chain.size() && std::memcmp(AsPointer(site), code, sizeof(code)) == 0 && call() == 5,
+			"hook chain site not restored");
+		dku_assert(!dku::Hook::HookChain::Owns(site, sizeof(code)),
+			"hook chain still owns restored site");
+	}
+
+	// per call cost of preserving simd state with register moves and with xsave
+	void TestNonVolatileBenchmark()
+	{
+		using patch_t = void (*)();
+
+		constexpr std::size_t calls = static_cast<std::size_t>(1) << 20;
+
+#if defined(SKSEAPI)
+		SKSE::AllocTrampoline(static_cast<std::size_t>(1) << 12);
+#else
+		dku::Hook::Trampoline::AllocTrampoline(static_cast<std::size_t>(1) << 14);
+#endif
+
+		// prolog | epilog | ret
+		auto build = [](dku::Hook::JIT::patch_descriptor a_patch) {
+			const auto& [prolog, epilog] = a_patch;
+			const auto entry = TRAM_ALLOC(prolog.Size + epilog.Size + sizeof(RET));
+			std::memcpy(AsPointer(entry), prolog.Data, prolog.Size);
+			std::memcpy(AsPointer(entry + prolog.Size), epilog.Data, epilog.Size);
+			AsMemCpy(entry + prolog.Size + epilog.Size, RET);
+			return std::bit_cast<patch_t>(entry);
+		};
+
+		auto bench = [](std::string_view a_mask, patch_t a_patch) {
+			a_patch();
+			const auto start = std::chrono::steady_clock::now();
+			for (std::size_t i = 0; i < calls; ++i) {
+				a_patch();
+			}
+			INFO("{} : {:.2f}ns per call", a_mask, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls);
+		};
+
+		bench("xmm0-5", build(dku::Hook::JIT::MakeNonVolatilePatch<SIMD::XMM0, SIMD::XMM1, SIMD::XMM2, SIMD::XMM3, SIMD::XMM4, SIMD::XMM5>()));
+		bench("xmm all", build(dku::Hook::JIT::MakeNonVolatilePatch<SIMD::ALL>()));
+
+		if (CPU::has_avx()) {
+			bench("ymm all", build(dku::Hook::JIT::MakeNonVolatilePatch<SIMD::ALL, AVX::YMM>()));
+		}
+
+		if (CPU::has_avx512()) {
+			bench("zmm all + k", build(dku::Hook::JIT::MakeNonVolatilePatch<SIMD::ALL, AVX::ZMM, AVX::K>()));
+		}
+
+		if (CPU::xcr0()) {
+			bench("xsave", build(dku::Hook::JIT::MakeNonVolatilePatch<AVX::XSAVE>()));
+		}
+	}
+
+	void TestPatchTransaction()
+	{
+		constexpr std::size_t size = 0x3000;
+
+		auto*      mem = static_cast<OpCode*>(::VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READ));
+		const auto base = AsAddress(mem);
+
+		{
+			dku::Hook::PatchTransaction transaction;
+			dku::Hook::WriteImm(base + 0xFFC, 0x1122334455667788ull);  // straddles two pages
+			dku::Hook::WriteImm(base + 0x10, static_cast<OpCode>(0xC3));
+			dku::Hook::WriteImm(base + 0x2000, static_cast<OpCode>(0x90));
+
+			dku_assert(transaction.size() == 3 && mem[0x10] == 0,
+				"queued writes applied before commit");
+		}
+
+		dku_assert(mem[0x10] == 0xC3 && mem[0x2000] == 0x90 && *dku::Hook::adjust_pointer<std::uint64_t>(mem, 0xFFC) == 0x1122334455667788ull,
+			"transaction writes incorrect");
+
+		::MEMORY_BASIC_INFORMATION mbi;
+		::VirtualQuery(mem, &mbi, sizeof(mbi));
+		dku_assert(mbi.Protect == PAGE_EXECUTE_READ && mbi.RegionSize == size,
+			"transaction protection not restored");
+
+		// other threads keep running until commit, then are suspended for the writes
+		std::atomic_bool   running{ true };
+		std::atomic_size_t spins{ 0 };
+		std::jthread       worker{ [&] {
+			while (running) {
+				++spins;
+			}
+		} };
+
+		{
+			dku::Hook::InstallBatch batch;
+			dku::Hook::WriteImm(base + 0x18, static_cast<OpCode>(0xE9));  // qword store
+			dku::Hook::WriteImm(base + 0x24, 0x1122334455667788ull);     // oword store
+			dku::Hook::WriteImm(base + 0x1FFE, 0xCCCCCCCCu);              // straddles two pages
+		}
+
+		dku_assert(mem[0x18] == 0xE9 && *dku::Hook::adjust_pointer<std::uint64_t>(mem, 0x24) == 0x1122334455667788ull && mem[0x2001] == 0xCC,
+			"install batch writes incorrect");
+
+		// worker is resumed after commit
+		const auto before = spins.load();
+		while (spins == before) {}
+		running = false;
+
+		::VirtualFree(mem, 0, MEM_RELEASE);
+	}
+
+	void TestTrampoline()
+	{
+		constexpr std::size_t size = 0x10000;
+
+		auto* mem = ::VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+		auto& trampoline = dku::Hook::Trampoline::GetTrampoline();
+		trampoline.set_trampoline(mem, size);
+
+		// same size class is reused after free
+		auto* cave = trampoline.allocate(0x50);
+		auto* thunk = trampoline.allocate(0x10);
+		dku_assert(trampoline.consumed() == 0x90 && trampoline.live() == 0x60,
+			"slab rounding incorrect");
+
+		trampoline.deallocate(cave, 0x50);
+		dku_assert(trampoline.idle() == 0x80 && trampoline.allocate(0x70) == cave && trampoline.consumed() == 0x90,
+			"slab free list not reused");
+
+		// large blocks are split on reuse
+		auto* large = trampoline.allocate(0x2010);
+		trampoline.deallocate(large, 0x2010);
+		dku_assert(trampoline.allocate(0x1800) == large && trampoline.allocate(0x800) == static_cast<std::byte*>(large) + 0x1800,
+			"large block not reused");
+
+		// hook churn stays within a fixed budget
+		for (auto i = 0; i < 0x1000; ++i) {
+			trampoline.deallocate(thunk, 0x10);
+			thunk = trampoline.allocate(0x10);
+		}
+		dku_assert(trampoline.consumed() == 0x90 + 0x2010 && trampoline.blocks().size() == 4,
+			"trampoline leaks on churn");
+
+		trampoline.release();
+		::VirtualFree(mem, 0, MEM_RELEASE);
+
+		// a region is lazily reserved for each hook site out of reach
+		namespace tramp = dku::Hook::Trampoline;
+
+		const auto [textx, textSize] = dku::Hook::Module::get().section(dku::Hook::Module::Section::textx);
+		const std::uintptr_t sites[] = { textx, textx + textSize, textx + (static_cast<std::uintptr_t>(1) << 34) };
+
+		trampoline.PageAlloc(0x10000);
+		for (auto site : sites) {
+			auto* thunk = trampoline.allocate(0x20, site);
+			dku_assert(tramp::detail::distance(AsAddress(thunk), site) <= tramp::REACH,
+				"trampoline allocation out of reach\nsite : {:X}\nthunk : {:X}", site, AsAddress(thunk));
+		}
+
+		dku_assert(trampoline.regions().size() == 2,
+			"trampoline pool reserved unexpected regions");
+
+		// identical thunks are shared within reach, freed with the last reference
+		constexpr std::uint8_t bytes[] = { 0xFF, 0x25, 0xF2, 0xFF, 0xFF, 0xFF };
+		auto*                  first = trampoline.intern(bytes, sizeof(bytes), sites[0]);
+		auto*                  second = trampoline.intern(bytes, sizeof(bytes), sites[1]);
+		auto*                  far = trampoline.intern(bytes, sizeof(bytes), sites[2]);
+		dku_assert(first == second && first != far && trampoline.shared() == sizeof(bytes),
+			"identical thunks not shared");
+
+		const auto live = trampoline.live();
+		trampoline.deallocate(second, sizeof(bytes));
+		dku_assert(trampoline.live() == live && !std::memcmp(first, bytes, sizeof(bytes)),
+			"shared thunk freed with references left");
+
+		trampoline.deallocate(first, sizeof(bytes));
+		dku_assert(trampoline.live() == live - sizeof(bytes),
+			"shared thunk not freed with last reference");
+
+		trampoline.release();
+	}
+
+	namespace Profile
+	{
+		inline std::uintptr_t Vtbl[1]{};
+
+		std::int64_t Sum(std::int64_t a_1, std::int64_t a_2, std::int64_t a_3, std::int64_t a_4, std::int64_t a_5, std::int64_t a_6, std::int64_t a_7, std::int64_t a_8)
+		{
+			return a_1 + a_2 * 2 + a_3 * 3 + a_4 * 4 + a_5 * 5 + a_6 * 6 + a_7 * 7 + a_8 * 8;
+		}
+
+		double Scale(double a_value)
+		{
+			return a_value * 0.5;
+		}
+	}
+
+	// counters of profiled hooks, stack arguments and return values pass through the thunk
+	void TestHookStats()
+	{
+		using site_t = int (*)();
+		using sum_t = std::int64_t (*)(std::int64_t, std::int64_t, std::int64_t, std::int64_t, std::int64_t, std::int64_t, std::int64_t, std::int64_t);
+		using scale_t = double (*)(double);
+
+		constexpr std::size_t calls = static_cast<std::size_t>(1) << 16;
+
+#if defined(SKSEAPI)
+		SKSE::AllocTrampoline(static_cast<std::size_t>(1) << 10);
+#else
+		dku::Hook::Trampoline::AllocTrampoline(static_cast<std::size_t>(1) << 12);
+#endif
+
+		// sub rsp, 0x28 | mov eax, 1 | call Callee | add rsp, 0x28 | ret
+		OpCode                   code[] = { 0x48, 0x83, 0xEC, 0x28, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xE8, 0x00, 0x00, 0x00, 0x00, 0x48, 0x83, 0xC4, 0x28, 0xC3 };
+		constexpr std::ptrdiff_t movSite = 0x4;
+		constexpr std::ptrdiff_t callSite = 0x9;
+
+		const auto site = TRAM_ALLOC_NEAR(sizeof(code), AsAddress(&Latency::Callee));
+		AsMemCpy(code + callSite + 1, static_cast<Disp32>(AsAddress(&Latency::Callee) - (site + callSite + sizeof(JmpRel))));
+		std::memcpy(AsPointer(site), code, sizeof(code));
+
+		const auto call = [site]() { return std::bit_cast<site_t>(site)(); };
+		const auto first = dku::Hook::HookStats::Snapshot().size();
+
+		auto rel = dku::Hook::AddRelHook<5, true>(site + callSite, AsAddress(&Latency::Detour), HookFlag::kProfile);
+		rel->Enable();
+		for (std::size_t i = 0; i < calls; ++i) {
+			call();
+		}
+		rel->Disable();
+
+		auto cave = dku::Hook::AddCaveHook(site, { movSite, callSite }, FUNC_INFO(Latency::Probe), std::make_pair(nullptr, 0), std::make_pair(nullptr, 0), HookFlag::kProfile);
+		cave->Enable();
+		call();
+		cave->Disable();
+
+		// vtbl[0] Sum, 8 arguments spill to stack on both abi
+		Profile::Vtbl[0] = AsAddress(&Profile::Sum);
+		void* object = Profile::Vtbl;
+		auto  vmt = dku::Hook::AddVMTHook(&object, 0, FUNC_INFO(Profile::Sum), std::make_pair(nullptr, 0), HookFlag::kProfile);
+		vmt->Enable();
+		dku_assert(std::bit_cast<sum_t>(Profile::Vtbl[0])(1, 2, 3, 4, 5, 6, 7, 8) == 204,
+			"profiled hook arguments incorrect");
+		vmt->Disable();
+
+		Profile::Vtbl[0] = AsAddress(&Profile::Scale);
+		auto scale = dku::Hook::AddVMTHook(&object, 0, FUNC_INFO(Profile::Scale), std::make_pair(nullptr, 0), HookFlag::kProfile);
+		scale->Enable();
+		dku_assert(std::bit_cast<scale_t>(Profile::Vtbl[0])(3.0) == 1.5,
+			"profiled hook return value incorrect");
+		scale->Disable();
+
+		const auto stats = dku::Hook::HookStats::Snapshot();
+		dku_assert(stats.size() == first + 4,
+			"profiled hooks not registered");
+		dku_assert(stats[first].Address == site + callSite && stats[first].Name == fmt::format("{}.{:X}", PROJECT_NAME, AsAddress(&Latency::Detour)) &&
+					   stats[first].Calls == calls && stats[first].Cycles >= stats[first].MaxCycles && stats[first].MaxCycles,
+			"rel hook counters incorrect\ncalls : {}", stats[first].Calls);
+		dku_assert(stats[first + 1].Name == "Latency::Probe" && stats[first + 1].Calls == 1 && stats[first + 2].Calls == 1 && stats[first + 3].Calls == 1,
+			"cave/vmt hook counters incorrect");
+
+		for (const auto& entry : stats) {
+			INFO("{} @ {:X} : {} calls | {:.1f} avg | {} max cycles", entry.Name, entry.Address, entry.Calls, entry.AverageCycles(), entry.MaxCycles);
+		}
+
+		dku::Hook::HookStats::Reset();
+		dku_assert(!dku::Hook::HookStats::Snapshot()[first].Calls,
+			"counters not reset");
+	}
+
+	// caller histogram of a cave hooked function and a vtable entry
+	void TestCallerProfiler()
+	{
+		using site_t = int (*)();
+
+		constexpr std::size_t calls = 0x100;
+
+#if defined(SKSEAPI)
+		SKSE::AllocTrampoline(static_cast<std::size_t>(1) << 10);
+#else
+		dku::Hook::Trampoline::AllocTrampoline(static_cast<std::size_t>(1) << 12);
+#endif
+
+		// mov eax, 1 | ret
+		constexpr OpCode function[] = { 0xB8, 0x01, 0x00, 0x00, 0x00, 0xC3 };
+		// sub rsp, 0x28 | call function | add rsp, 0x28 | ret
+		OpCode                   code[] = { 0x48, 0x83, 0xEC, 0x28, 0xE8, 0x00, 0x00, 0x00, 0x00, 0x48, 0x83, 0xC4, 0x28, 0xC3 };
+		constexpr std::ptrdiff_t callSite = 0x4;
+
+		const auto callee = TRAM_ALLOC(sizeof(function));
+		std::memcpy(AsPointer(callee), function, sizeof(function));
+
+		const auto site = TRAM_ALLOC_NEAR(sizeof(code), callee);
+		AsMemCpy(code + callSite + 1, static_cast<Disp32>(callee - (site + callSite + sizeof(CallRel))));
+		std::memcpy(AsPointer(site), code, sizeof(code));
+
+		// every call is sampled, all from the same return address
+		auto cave = dku::Hook::CallerProfiler::AttachCave(callee, 1);
+		cave->Enable();
+		for (std::size_t i = 0; i < calls; ++i) {
+			dku_assert(std::bit_cast<site_t>(site)() == 1,
+				"sampled function return value incorrect");
+		}
+		cave->Disable();
+
+		const auto top = cave->Top();
+		dku_assert(top.size() == 1 && top[0].Address == site + callSite + sizeof(CallRel) && top[0].Samples == calls,
+			"cave caller profile incorrect\nsamples : {}", top.empty() ? 0 : top[0].Samples);
+		dku_assert(top[0].Module.empty() && !top[0].RawAddress,
+			"trampoline caller is symbolized\nmodule : {}", top[0].Module);
+
+		// vtbl[0] callee, one in 4 calls is sampled
+		Profile::Vtbl[0] = callee;
+		void* object = Profile::Vtbl;
+		auto  vmt = dku::Hook::CallerProfiler::AttachVMT(&object, 0, 4);
+		vmt->Enable();
+		for (std::size_t i = 0; i < calls; ++i) {
+			std::bit_cast<site_t>(std::atomic_ref{ Profile::Vtbl[0] }.load())();
+		}
+		vmt->Disable();
+
+		dku_assert(vmt->Samples() == calls / 4 && !dku::Hook::CallerProfiler::Dropped(),
+			"vmt caller profile incorrect\nsamples : {}", vmt->Samples());
+
+		// the loop above is the caller, inside this module
+		const auto* module = dku::Hook::ModuleFor(AsAddress(&Profile::Scale));
+		dku_assert(module, "test module not found");
+
+		const auto callers = vmt->Top();
+		dku_assert(!callers.empty(), "vmt caller profile is empty");
+		for (const auto& caller : callers) {
+			INFO("{:X} ({} @ {:X}) : {} samples", caller.Address, caller.Module, caller.RawAddress, caller.Samples);
+			dku_assert(caller.Module == module->name() && caller.RawAddress == dku::Hook::GetRawAddress(caller.Address),
+				"module caller is not symbolized\nmodule : {}\nraw    : {:X}", caller.Module, caller.RawAddress);
+		}
 	}
 
 	void TestHooks()
@@ -236,27 +950,6 @@ namespace Test::Hook
 		Impl::FallbackDistanceHook::InstallHook();
 	}
 
-#define PACK_BIG_ENDIAN(lo1, lo2, hi1, hi2) ((((lo1)&0xFF) << 0) | (((lo2)&0xFF) << 8) | (((hi1)&0xFF) << 16) | ((hi2)&0xFF) << 24)
-	void TestDispHelpers()
-	{
-		// clang-format off
-		constexpr OpCode asmBuf[] = { 0x8C, 0x05, 0x78, 0x56, 0x34, 0x12, };
-		// clang-format on
-
-		auto rip = &asmBuf[0];
-		INFO("rip {:X}", AsAddress(rip));
-		INFO("Op : 0x{:2X}", rip[0]);
-		auto dst = dku::Hook::GetDisp(rip);
-		INFO("dst : 0x{:X}", dst);
-		auto disp = dst - AsAddress(rip) - sizeof(asmBuf);
-		INFO("disp : 0x{:X}", disp);
-
-		auto offset = sizeof(asmBuf) - sizeof(Disp32);
-		auto packed = PACK_BIG_ENDIAN(asmBuf[offset + 0], asmBuf[offset + 1], asmBuf[offset + 2], asmBuf[offset + 3]);
-		dku_assert(packed == disp,
-			"incorrect");
-	}
-
 	void TestJIT()
 	{
 		// 1) regular registers all
@@ -339,11 +1032,76 @@ namespace Test::Hook
 		}
 	}
 
+	// compile time non volatile patches against the runtime encoder
+	void TestNonVolatilePatch()
+	{
+		// 1) compile time patch, same as combined runtime patches
+		{
+			static_assert(dku::Hook::JIT::detail::nonvolatile_size(std::to_underlying(Register::ALL), std::to_underlying(SIMD::ALL)) == 0x97);
+
+			auto [prolog, epilog] = dku::Hook::JIT::MakeNonVolatilePatch<Register::RDI, Register::RBX, SIMD::XMM0, SIMD::XMM7, SIMD::XMM10>();
+			auto [prolog1, epilog1] = dku::Hook::JIT::MakeNonVolatilePatch({ Register::RBX, Register::RDI });
+			auto [prolog2, epilog2] = dku::Hook::JIT::MakeNonVolatilePatch({ SIMD::XMM0, SIMD::XMM7, SIMD::XMM10 });
+			prolog1.Append(prolog2);
+			epilog2.Append(epilog1);
+
+			dku_assert(std::ranges::equal(std::span<OpCode>{ prolog }, std::span<OpCode>{ prolog1 }),
+				"compile time prolog incorrect");
+			dku_assert(std::ranges::equal(std::span<OpCode>{ epilog }, std::span<OpCode>{ epilog2 }),
+				"compile time epilog incorrect");
+		}
+
+		// 2) avx widths, encoded regardless of cpu support
+		{
+			constexpr auto simds = std::to_underlying(SIMD::XMM0) | std::to_underlying(SIMD::XMM9);
+			constexpr auto ymm = dku::Hook::JIT::detail::nonvolatile_block<0, simds, 0x20, 0x0>;
+			constexpr auto zmm = dku::Hook::JIT::detail::nonvolatile_block<0, simds, 0x40, 0x8>;
+			constexpr auto kmovw = dku::Hook::JIT::detail::nonvolatile_block<0, 0, 0x10, 0x2>;
+			// clang-format off
+			constexpr OpCode expected_ymm[] = { 0x48, 0x81, 0xEC, 0x40, 0x00, 0x00, 0x00, 0xC5, 0xFE, 0x7F, 0x04, 0x24, 0xC5, 0x7E, 0x7F, 0x4C, 0x24, 0x20, 0xC5, 0x7E, 0x6F, 0x4C, 0x24, 0x20, 0xC5, 0xFE, 0x6F, 0x04, 0x24, 0x48, 0x81, 0xC4, 0x40, 0x00, 0x00, 0x00 };
+			// vmovdqu64 [rsp + 0x40], zmm9 is disp8 * 64, kmovq [rsp + 0x80], k0
+			constexpr OpCode expected_zmm[] = { 0x48, 0x81, 0xEC, 0xC0, 0x00, 0x00, 0x00, 0x62, 0xF1, 0xFE, 0x48, 0x7F, 0x04, 0x24, 0x62, 0x71, 0xFE, 0x48, 0x7F, 0x4C, 0x24, 0x01, 0xC4, 0xE1, 0xF8, 0x91, 0x84, 0x24, 0x80, 0x00, 0x00, 0x00 };
+			// avx512f without bw, kmovw [rsp], k0 | kmovw [rsp + 0x8], k1
+			constexpr OpCode expected_kmovw[] = { 0x48, 0x81, 0xEC, 0x40, 0x00, 0x00, 0x00, 0xC5, 0xF8, 0x91, 0x04, 0x24, 0xC5, 0xF8, 0x91, 0x4C, 0x24, 0x08 };
+			// clang-format on
+
+			static_assert(std::ranges::equal(ymm, expected_ymm));
+			static_assert(zmm.size() == 2 * (sizeof(expected_zmm) + 7 * 10) && std::ranges::equal(std::span{ zmm }.first(sizeof(expected_zmm)), expected_zmm));
+			static_assert(std::ranges::equal(std::span{ kmovw }.first(sizeof(expected_kmovw)), expected_kmovw));
+		}
+
+		// 3) avx widths picked for the running cpu
+		{
+			auto [prolog, epilog] = dku::Hook::JIT::MakeNonVolatilePatch<SIMD::XMM0, SIMD::XMM9, AVX::ZMM, AVX::K>();
+			auto [prolog1, epilog1] = dku::Hook::JIT::MakeNonVolatilePatch({ SIMD::XMM0, SIMD::XMM9 }, { AVX::ZMM, AVX::K });
+
+			dku_assert(std::ranges::equal(std::span<OpCode>{ prolog }, std::span<OpCode>{ prolog1 }) && std::ranges::equal(std::span<OpCode>{ epilog }, std::span<OpCode>{ epilog1 }),
+				"compile time avx patch differs from runtime patch");
+		}
+	}
+
 	void Run()
 	{
 		//TestHooks();
 		TestPattern();
-		//TestDispHelpers();
+		TestPatternBenchmark();
+		TestPatternSet();
+		TestSignatureCache();
+		TestPEImage();
+		TestSymbolIndex();
+		TestModuleRegistry();
+		TestFunctionAt();
+		TestVMTShadow();
+		TestHookChain();
+		TestNonVolatilePatch();
+		TestNonVolatileBenchmark();
+		TestDisasm();
+		TestDispHelpers();
+		TestPatchTransaction();
+		TestTrampoline();
+		TestHookLatency();
+		TestHookStats();
+		TestCallerProfiler();
 		//TestJIT();
 
 		//dku::Hook::write_call_ex<6>(0, Run, { Register::RAX, Register::RCX, Register::RDX, Register::RBX });
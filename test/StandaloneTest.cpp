@@ -0,0 +1,24 @@
+#include <string_view>
+
+// standalone target, no game process or skse, built with DKUTIL_BUILD_TESTS and run by ctest
+namespace Plugin
+{
+	inline constexpr std::string_view NAME = "DKUtilTest";
+}
+
+#include "HookCoreTest.h"
+
+int main()
+{
+	DKUtil::Logger::Init(Plugin::NAME, "standalone");
+
+	Test::Hook::TestDisasm();
+	Test::Hook::TestDispHelpers();
+	Test::Hook::TestHookLatency();
+#if !defined(_WIN32)
+	Test::Hook::TestInstallBatchBlocked();
+#endif
+
+	INFO("++++++ Standalone tests passed");
+	return 0;
+}